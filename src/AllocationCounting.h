@@ -0,0 +1,36 @@
+#ifndef ALLOCATION_COUNTING_H
+#define ALLOCATION_COUNTING_H
+
+#include <cstdlib>
+#include <new>
+
+#include "Instrument.h"
+
+// Counts heap allocations for the "allocations" counter of Instrument.h by replacing the global operator new
+// and delete. Only the tarjan and schmidt binaries include this, once, in their translation unit; the library
+// and the other tools keep the allocator of the program they are part of.
+//
+// The replacements stay out of line: inlined into a caller, the free in operator delete meets a pointer that GCC
+// knows came from operator new and -Wmismatched-new-delete fires, although the pair is matched.
+__attribute__((noinline)) void *operator new(std::size_t size)
+{
+    if (InstrumentationEnabled())
+        Stats().allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+// the nothrow form too (std::stable_sort asks for its buffer with it), so that no block goes to a mismatched delete
+__attribute__((noinline)) void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    if (InstrumentationEnabled())
+        Stats().allocations.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size != 0 ? size : 1);
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void *p, std::size_t) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void *p, const std::nothrow_t &) noexcept { free(p); }
+
+#endif
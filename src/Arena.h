@@ -0,0 +1,94 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstdlib>
+#include <vector>
+
+#include "Instrument.h"
+
+// A bump allocator for the many small, short-lived arrays of one run (the back edges of every DFS tree and the
+// ears of the legacy ear walk). Allocations are carved out of large blocks
+// and never freed one by one: everything goes at once when the arena is released or destroyed, so a run
+// costs a handful of calls to malloc however many trees and ears it has.
+class Arena
+{
+  public:
+    static constexpr size_t BLOCK_BYTES = size_t(1) << 20;
+
+    Arena() = default;
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    ~Arena() { Release(); }
+
+    // alignment must be a power of two no larger than that of malloc
+    void *Allocate(size_t bytes, size_t alignment)
+    {
+        size_t pos = (used + alignment - 1) & ~(alignment - 1);
+        if (blocks.empty() || pos + bytes > capacity)
+        {
+            // a request larger than a block gets a block of its own
+            capacity = std::max(BLOCK_BYTES, bytes);
+            blocks.push_back(static_cast<char *>(malloc(capacity)));
+            if (blocks.back() == nullptr)
+                throw std::bad_alloc();
+            pos = 0;
+            CountEvent("arena blocks", 1);
+        }
+        used = pos + bytes;
+        return blocks.back() + pos;
+    }
+
+    // frees every block; whatever was allocated from the arena is gone
+    void Release()
+    {
+        for (auto block : blocks)
+        {
+            free(block);
+        }
+        blocks.clear();
+        used = capacity = 0;
+    }
+
+  private:
+    std::vector<char *> blocks;
+    size_t used = 0;     // bytes handed out from the last block
+    size_t capacity = 0; // size of the last block
+};
+
+// Lets standard containers allocate from an arena; deallocation is a no-op, the memory is reclaimed with the
+// arena. A default-constructed allocator has no arena and uses the heap, so that containers with it work as
+// usual outside the runs that set one up.
+template <typename T>
+struct ArenaAllocator
+{
+    using value_type = T;
+    Arena *arena = nullptr;
+
+    ArenaAllocator() = default;
+    explicit ArenaAllocator(Arena &arena) : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(size_t count)
+    {
+        if (arena == nullptr)
+            return static_cast<T *>(::operator new(count * sizeof(T)));
+        return static_cast<T *>(arena->Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, size_t)
+    {
+        if (arena == nullptr)
+            ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "Loader.h"
+#include "OutputWriter.h"
+#include "ThreadPool.h"
+#include "utils.h"
+
+// Batch mode: analyses the graphs listed in a manifest (one path per line, blank lines and lines starting with
+// '#' skipped) or found in a directory (every .in, .mtx and .bcsr file, by name) in one process. Each graph is
+// loaded and analysed on one thread, the graphs spread over the thread pool, largest file first so that a big
+// graph taken last does not leave the other threads idle. Every thread keeps its DFS state, result arrays and
+// output buffer from one graph to the next. The results form one stream, in the order of the input, each
+// introduced by a "Graph <path>: ..." line, and a last line sums up the batch.
+
+// what a thread keeps from one graph to the next, so that only the first graphs it takes pay for growing it
+struct BatchScratch
+{
+    // collects the output of one graph
+    struct TextBuffer : std::streambuf
+    {
+        std::string text;
+
+        std::streamsize xsputn(const char *data, std::streamsize count) override
+        {
+            text.append(data, static_cast<size_t>(count));
+            return count;
+        }
+
+        int overflow(int c) override
+        {
+            if (c != EOF)
+                text.push_back(static_cast<char>(c));
+            return c;
+        }
+    };
+
+    DFSState State;
+    std::vector<Tree> DFSForest;
+    BiconnectivityResult result;
+    TextBuffer buffer;
+    std::ostream stream{&buffer};
+    OutputWriter out{stream, 1 << 16};
+};
+
+// analyses graph, which is undirected, into result and prints it to out at the given verbosity
+using BatchEngine = void (*)(Graph &graph, BiconnectivityResult &result, OutputWriter &out, Verbosity verbosity);
+
+// the paths listed in the manifest at path, or the graph files in the directory at path, in order
+std::vector<std::string> ListBatchInputs(const char *path)
+{
+    std::vector<std::string> inputs;
+    auto IsGraphFile = [](const std::string &name) {
+        return EndsWith(name.c_str(), ".in") || EndsWith(name.c_str(), ".mtx") || EndsWith(name.c_str(), ".bcsr");
+    };
+
+    struct stat info;
+    if (stat(path, &info) == 0 && S_ISDIR(info.st_mode))
+    {
+        DIR *dir = opendir(path);
+        if (dir == nullptr)
+        {
+            cout << "Error: could not read the directory " << path << "\n";
+            exit(1);
+        }
+        std::string prefix = std::string(path) + (EndsWith(path, "/") ? "" : "/");
+        while (dirent *entry = readdir(dir))
+        {
+            if (IsGraphFile(entry->d_name))
+                inputs.push_back(prefix + entry->d_name);
+        }
+        closedir(dir);
+        std::sort(inputs.begin(), inputs.end());
+        return inputs;
+    }
+
+    std::ifstream manifest(path);
+    if (!manifest.is_open())
+    {
+        cout << "Error: could not open the manifest " << path << "\n";
+        exit(1);
+    }
+    std::string line;
+    while (std::getline(manifest, line))
+    {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+        size_t last = line.find_last_not_of(" \t\r");
+        std::string input = line.substr(first, last - first + 1);
+        if (!IsGraphFile(input))
+        {
+            cout << "Error: " << path << ": " << input << " does not end in .in, .mtx or .bcsr\n";
+            exit(1);
+        }
+        inputs.push_back(input);
+    }
+    return inputs;
+}
+
+// batch manifest.txt|directory [--output=summary|cut|bridges|full] [--threads=N] [--stats=stats.json]
+int BatchMain(int argc, char *argv[], const char *program, BatchEngine analyse)
+{
+    std::ios::sync_with_stdio(false);
+    unsigned NumThreads = std::thread::hardware_concurrency();
+    Verbosity verbosity = VERBOSITY_FULL;
+    const char *StatsPath = nullptr;
+    std::vector<char *> paths;
+    for (int i = 2; i < argc; ++i)
+    {
+        const char *value;
+        if (MatchOption(argv[i], "--threads", value) && ParseThreadCount(value) != 0)
+            NumThreads = ParseThreadCount(value);
+        else if (MatchOption(argv[i], "--output", value) && ParseVerbosity(value, verbosity))
+            continue;
+        else if (MatchOption(argv[i], "--stats", value))
+            StatsPath = value;
+        else
+            paths.push_back(argv[i]);
+    }
+    if (paths.size() != 1)
+    {
+        cout << "Usage: " << program << " batch manifest.txt|directory [--output=summary|cut|bridges|full] [--threads=N] [--stats=stats.json]\n";
+        return 1;
+    }
+    if (StatsPath != nullptr)
+        EnableInstrumentation();
+
+    std::vector<std::string> inputs = ListBatchInputs(paths[0]);
+    uint32_t count = static_cast<uint32_t>(inputs.size());
+    std::vector<uint64_t> bytes(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        struct stat info;
+        if (stat(inputs[i].c_str(), &info) != 0)
+        {
+            cout << "Error: could not open " << inputs[i] << "\n";
+            exit(1);
+        }
+        bytes[i] = static_cast<uint64_t>(info.st_size);
+    }
+    std::vector<uint32_t> LargestFirst(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        LargestFirst[i] = i;
+    }
+    std::stable_sort(LargestFirst.begin(), LargestFirst.end(), [&bytes](uint32_t a, uint32_t b) { return bytes[a] > bytes[b]; });
+
+    // the output of a graph finished before all the graphs ahead of it waits in pending
+    std::mutex OutputMutex;
+    std::vector<std::string> pending(count);
+    std::vector<bool> finished(count, false);
+    uint32_t NextToWrite = 0;
+    std::atomic<uint64_t> vertices{0}, edges{0};
+
+    Timer t;
+    {
+        ScopedPhase phase("batch");
+        ThreadPool pool(NumThreads);
+        pool.Run(count, [&](uint32_t k) {
+            thread_local BatchScratch scratch;
+            uint32_t i = LargestFirst[k];
+            InstrumentationMuted = true;
+
+            Graph graph = LoadGraph(inputs[i].c_str());
+            MakeUndirected(graph);
+            vertices += graph.n;
+            edges += graph.m / 2;
+            scratch.out << "Graph " << inputs[i].c_str() << ": " << graph.n << " vertices, " << graph.m / 2 << " edges\n";
+            graph.State = std::move(scratch.State);
+            graph.DFSForest = std::move(scratch.DFSForest);
+            analyse(graph, scratch.result, scratch.out, verbosity);
+            scratch.out.Flush();
+            scratch.State = std::move(graph.State);
+            scratch.DFSForest = std::move(graph.DFSForest);
+            InstrumentationMuted = false;
+
+            std::lock_guard<std::mutex> lock(OutputMutex);
+            if (i != NextToWrite)
+            {
+                pending[i] = std::move(scratch.buffer.text);
+                finished[i] = true;
+            }
+            else
+            {
+                cout << scratch.buffer.text;
+                for (++NextToWrite; NextToWrite < count && finished[NextToWrite]; ++NextToWrite)
+                {
+                    cout << pending[NextToWrite];
+                    std::string().swap(pending[NextToWrite]);
+                }
+            }
+            scratch.buffer.text.clear();
+        });
+    }
+    NumThreads = std::max(NumThreads, 1u);
+    cout << "Batch: " << count << " graphs, " << vertices.load() << " vertices, " << edges.load() << " edges in " << t.Stop()
+         << " ms on " << NumThreads << (NumThreads == 1 ? " thread\n" : " threads\n");
+    CountEvent("graphs", count);
+    CountEvent("vertices", vertices.load());
+    CountEvent("edges", edges.load());
+    if (StatsPath != nullptr)
+        WriteInstrumentationJson(StatsPath);
+    return 0;
+}
+
+#endif
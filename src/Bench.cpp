@@ -0,0 +1,338 @@
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cmath>
+
+#include "ChainDecomposition.h"
+#include "Generators.h"
+#include "Loader.h"
+#include "OutputWriter.h"
+#include "Reorder.h"
+#include "TarjanHopcroft.h"
+#include "TarjanVishkin.h"
+#include "Timer.h"
+#include "utils.h"
+
+// Benchmarks the tarjan and schmidt engines over input files and generated graph families.
+// Every (workload, engine) pair runs in a child process of its own, so that its peak RSS is its own;
+// the child repeats the run and sends the summary back through a pipe.
+
+enum Phase
+{
+    PHASE_LOAD,    // reading the file, or generating the graph
+    PHASE_PREPARE, // MakeUndirected, and the relabelling for tarjan-rcm
+    PHASE_COMPUTE, // the engine, and mapping the result back for tarjan-rcm
+    PHASE_PRINT,   // formatting the result as the binaries do, into a discarding stream
+    NUM_PHASES
+};
+const char *PHASE_NAMES[NUM_PHASES] = {"load", "prepare", "compute", "print"};
+const char *ENGINES[] = {"tarjan", "tarjan-rcm", "tarjan-parallel", "schmidt"};
+
+struct BenchOptions
+{
+    std::vector<std::string> workloads;
+    unsigned repeats = 5;
+    unsigned NumThreads = std::thread::hardware_concurrency();
+    uint32_t scale = 1000000; // vertices of the default generated families
+    bool families = true;
+    std::string CsvPath = "bench.csv";
+    std::string JsonPath = "bench.json";
+};
+
+// what a child reports for one (workload, engine) pair; plain data, it crosses a pipe
+struct Measurement
+{
+    uint64_t n;
+    uint64_t m;                  // undirected edges
+    double median[NUM_PHASES];   // milliseconds
+    double p95[NUM_PHASES];
+    double TotalMedian;
+    double EdgesPerSecond;       // m / median compute time
+    long PeakRSSKiB;
+};
+
+struct DiscardBuffer : std::streambuf
+{
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char *, std::streamsize count) override { return count; }
+};
+
+void CheckArgs(int argc, char *argv[], BenchOptions &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *value;
+        if (MatchOption(argv[i], "--repeats", value))
+        {
+            options.repeats = static_cast<unsigned>(std::min<uint64_t>(ParsePositive(value), 1000000));
+            if (options.repeats == 0)
+            {
+                cout << "--repeats expects a positive number\n";
+                exit(1);
+            }
+        }
+        else if (MatchOption(argv[i], "--scale", value))
+        {
+            uint64_t scale = ParsePositive(value);
+            if (scale == 0 || scale >= UINT32_MAX / 4)
+            {
+                cout << "--scale expects a positive number below " << UINT32_MAX / 4 << "\n";
+                exit(1);
+            }
+            options.scale = static_cast<uint32_t>(scale);
+        }
+        else if (MatchOption(argv[i], "--threads", value))
+        {
+            options.NumThreads = ParseThreadCount(value);
+            if (options.NumThreads == 0)
+            {
+                cout << "--threads expects a positive number\n";
+                exit(1);
+            }
+        }
+        else if (MatchOption(argv[i], "--csv", value))
+        {
+            options.CsvPath = value;
+        }
+        else if (MatchOption(argv[i], "--json", value))
+        {
+            options.JsonPath = value;
+        }
+        else if (!strcmp(argv[i], "--no-families"))
+        {
+            options.families = false;
+        }
+        else if (argv[i][0] == '-')
+        {
+            cout << "Usage: ./benchmark [--repeats=N] [--threads=N] [--scale=N] [--no-families] [--csv=path] [--json=path] [file.in|file.mtx|file.bcsr|family:params ...]\n";
+            cout << "Families: path:N, grid:R:C, random:N:M[:SEED], rmat:SCALE:M[:SEED], cliques:K:S[:SEED] (see Generators.h);\n";
+            cout << "--scale sets the size of the default ones\n";
+            exit(1);
+        }
+        else
+        {
+            options.workloads.push_back(argv[i]);
+        }
+    }
+
+    if (options.families)
+    {
+        uint32_t side = static_cast<uint32_t>(std::sqrt(double(options.scale)));
+        options.workloads.push_back("path:" + std::to_string(options.scale));
+        options.workloads.push_back("grid:" + std::to_string(side) + ":" + std::to_string(side));
+        options.workloads.push_back("random:" + std::to_string(options.scale) + ":" + std::to_string(4 * uint64_t(options.scale)));
+    }
+    for (auto &workload : options.workloads)
+    {
+        FamilySpec family;
+        bool IsFile = EndsWith(workload.c_str(), ".in") || EndsWith(workload.c_str(), ".mtx") || EndsWith(workload.c_str(), ".bcsr");
+        if (!IsFile && !ParseFamilySpec(workload, family))
+        {
+            cout << "Not an input file or a graph family: " << workload << "\n";
+            exit(1);
+        }
+    }
+}
+
+// sorted samples -> (median, 95th percentile)
+std::pair<double, double> Summarise(std::vector<double> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    size_t k = samples.size();
+    double median = k % 2 ? samples[k / 2] : (samples[k / 2 - 1] + samples[k / 2]) / 2;
+    size_t rank = static_cast<size_t>(std::ceil(0.95 * double(k)));
+    return {median, samples[std::max<size_t>(rank, 1) - 1]};
+}
+
+// runs in the child: repeats the whole pipeline for one workload and engine
+Measurement Measure(const std::string &workload, const std::string &engine, const BenchOptions &options)
+{
+    std::vector<double> samples[NUM_PHASES];
+    std::vector<double> totals;
+    Measurement result;
+    memset(&result, 0, sizeof(result));
+    DiscardBuffer discard;
+    std::ostream discarding(&discard);
+    std::unique_ptr<ThreadPool> pool;
+    if (engine == "tarjan-parallel")
+        pool = std::make_unique<ThreadPool>(options.NumThreads);
+
+    for (unsigned r = 0; r < options.repeats; ++r)
+    {
+        double times[NUM_PHASES];
+        Timer t;
+
+        Graph graph(0);
+        if (!GenerateFamily(workload, graph))
+            graph = LoadGraph(workload.c_str(), options.NumThreads);
+        times[PHASE_LOAD] = t.Stop();
+
+        t.Start();
+        MakeUndirected(graph);
+        VertexRelabelling relabelling;
+        Graph relabelled(0);
+        if (engine == "tarjan-rcm")
+            relabelled = RelabelGraph(graph, ORDER_RCM, relabelling);
+        times[PHASE_PREPARE] = t.Stop();
+
+        t.Start();
+        BiconnectivityResult found;
+        if (engine == "tarjan")
+        {
+            TarjanHopcroft(graph, found);
+        }
+        else if (engine == "tarjan-rcm")
+        {
+            TarjanHopcroft(relabelled, found);
+            MapResultBack(graph, relabelling, found);
+        }
+        else if (engine == "tarjan-parallel")
+        {
+            TarjanVishkin(graph, found, *pool);
+        }
+        else
+        {
+            Chains chains;
+            ChainDecomposition(graph, chains, found);
+        }
+        times[PHASE_COMPUTE] = t.Stop();
+
+        t.Start();
+        {
+            OutputWriter out(discarding);
+            PrintBiconnectivity(out, found);
+        }
+        times[PHASE_PRINT] = t.Stop();
+
+        double total = 0;
+        for (int p = 0; p < NUM_PHASES; ++p)
+        {
+            samples[p].push_back(times[p]);
+            total += times[p];
+        }
+        totals.push_back(total);
+        result.n = graph.n;
+        result.m = graph.AdjArray.size() / 2;
+    }
+
+    for (int p = 0; p < NUM_PHASES; ++p)
+    {
+        std::tie(result.median[p], result.p95[p]) = Summarise(samples[p]);
+    }
+    result.TotalMedian = Summarise(totals).first;
+    result.EdgesPerSecond = result.median[PHASE_COMPUTE] > 0 ? double(result.m) / (result.median[PHASE_COMPUTE] / 1000) : 0;
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    result.PeakRSSKiB = usage.ru_maxrss;
+    return result;
+}
+
+// forks a child for one (workload, engine) pair; false if the child failed
+bool MeasureInChild(const std::string &workload, const std::string &engine, const BenchOptions &options, Measurement &result)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+        return false;
+    cout.flush();
+    pid_t child = fork();
+    if (child < 0)
+        return false;
+    if (child == 0)
+    {
+        close(fds[0]);
+        Measurement measured = Measure(workload, engine, options);
+        bool sent = write(fds[1], &measured, sizeof(measured)) == sizeof(measured);
+        _exit(sent ? 0 : 1);
+    }
+
+    close(fds[1]);
+    bool received = read(fds[0], &result, sizeof(result)) == sizeof(result);
+    close(fds[0]);
+    int status;
+    waitpid(child, &status, 0);
+    return received && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// JSON string contents: workload names are paths or family specs, only quotes and backslashes need escaping
+std::string JsonEscape(const std::string &str)
+{
+    std::string escaped;
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+// a CSV field (RFC 4180): quoted, with its quotes doubled, if it holds a comma, a quote or a line break
+std::string CsvField(const std::string &str)
+{
+    if (str.find_first_of(",\"\r\n") == std::string::npos)
+        return str;
+    std::string quoted = "\"";
+    for (char c : str)
+    {
+        if (c == '"')
+            quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    CheckArgs(argc, argv, options);
+
+    std::ofstream csv(options.CsvPath), json(options.JsonPath);
+    if (!csv.is_open() || !json.is_open())
+    {
+        cout << "Error: cannot write " << options.CsvPath << " or " << options.JsonPath << "\n";
+        exit(1);
+    }
+    csv << "workload,engine,n,m,repeats";
+    for (auto phase : PHASE_NAMES)
+    {
+        csv << "," << phase << "_median_ms," << phase << "_p95_ms";
+    }
+    csv << ",total_median_ms,edges_per_sec,peak_rss_kib\n";
+    json << "{\"repeats\": " << options.repeats << ", \"threads\": " << options.NumThreads << ", \"runs\": [";
+
+    bool first = true, failed = false;
+    printf("%-32s %-16s %10s %10s %12s %12s %14s %10s\n", "workload", "engine", "n", "m", "compute ms", "total ms", "edges/s", "RSS MiB");
+    for (auto &workload : options.workloads)
+    {
+        for (auto engine : ENGINES)
+        {
+            Measurement r;
+            if (!MeasureInChild(workload, engine, options, r))
+            {
+                printf("%-32s %-16s failed\n", workload.c_str(), engine);
+                failed = true;
+                continue;
+            }
+            printf("%-32s %-16s %10lu %10lu %12.3f %12.3f %14.0f %10.1f\n", workload.c_str(), engine, (unsigned long)r.n,
+                   (unsigned long)r.m, r.median[PHASE_COMPUTE], r.TotalMedian, r.EdgesPerSecond, double(r.PeakRSSKiB) / 1024);
+            fflush(stdout);
+
+            csv << CsvField(workload) << "," << CsvField(engine) << "," << r.n << "," << r.m << "," << options.repeats;
+            json << (first ? "" : ",") << "\n  {\"workload\": \"" << JsonEscape(workload) << "\", \"engine\": \"" << engine
+                 << "\", \"n\": " << r.n << ", \"m\": " << r.m << ", \"phases\": {";
+            for (int p = 0; p < NUM_PHASES; ++p)
+            {
+                csv << "," << r.median[p] << "," << r.p95[p];
+                json << (p ? ", " : "") << "\"" << PHASE_NAMES[p] << "\": {\"median_ms\": " << r.median[p] << ", \"p95_ms\": " << r.p95[p] << "}";
+            }
+            csv << "," << r.TotalMedian << "," << r.EdgesPerSecond << "," << r.PeakRSSKiB << "\n";
+            json << "}, \"total_median_ms\": " << r.TotalMedian << ", \"edges_per_sec\": " << r.EdgesPerSecond
+                 << ", \"peak_rss_kib\": " << r.PeakRSSKiB << "}";
+            first = false;
+        }
+    }
+    json << "\n]}\n";
+    cout << "Wrote " << options.CsvPath << " and " << options.JsonPath << "\n";
+    return failed ? 1 : 0;
+}
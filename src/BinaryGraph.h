@@ -0,0 +1,326 @@
+#ifndef BINARY_GRAPH_H
+#define BINARY_GRAPH_H
+
+#include "MappedFile.h"
+#include "utils.h"
+
+// On-disk binary CSR graph (.bcsr), laid out so that a memory mapping of the file can be used as the
+// graph's arrays directly:
+//
+//   BinaryGraphHeader
+//   offsets[n + 1]         at header.OffsetsPos, 4 bytes each, 8 with BINARY_GRAPH_WIDE_OFFSETS
+//   neighbours[m]          at header.NeighboursPos, header.VertexIdBytes (2, 4 or 8) bytes each
+//   permutation[n]         at header.PermutationPos, as wide as the neighbours, only with BINARY_GRAPH_HAS_PERMUTATION
+//
+// Every array starts on a 64-byte boundary. Numbers are stored in the byte order of the machine that wrote
+// the file; ByteOrderMark tells a reader with the other byte order to reject it.
+// The permutation lists the vertex ids sorted by decreasing degree (ties by id). With BINARY_GRAPH_UNDIRECTED every
+// edge is stored both ways, and every neighbour list is sorted, without repeats or self-loops.
+// Ids are written as narrow as the graph allows (2 bytes below 65535 vertices) and offsets as wide as it needs
+// (8 bytes from 2^32 neighbour entries on, or with 8-byte ids). Version 1 files have 4-byte ids and offsets.
+
+const char BINARY_GRAPH_MAGIC[8] = {'B', 'C', 'C', 'G', 'R', 'A', 'P', 'H'};
+const uint32_t BINARY_GRAPH_VERSION = 2;
+const uint32_t BINARY_GRAPH_BYTE_ORDER_MARK = 0x01020304;
+const uint32_t BINARY_GRAPH_UNDIRECTED = 1u << 0;
+const uint32_t BINARY_GRAPH_HAS_PERMUTATION = 1u << 1;
+const uint32_t BINARY_GRAPH_WIDE_OFFSETS = 1u << 2;
+
+struct BinaryGraphHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t ByteOrderMark;
+    uint32_t flags;
+    uint32_t VertexIdBytes; // width of a vertex id: 2, 4 or 8
+    uint64_t n;
+    uint64_t m;             // number of neighbour entries, each undirected edge counts twice
+    uint64_t OffsetsPos;    // byte positions of the arrays in the file
+    uint64_t NeighboursPos;
+    uint64_t PermutationPos; // = 0 without a permutation
+
+    uint32_t OffsetBytes() const { return (flags & BINARY_GRAPH_WIDE_OFFSETS) ? 8 : 4; }
+};
+
+uint64_t AlignTo64(uint64_t pos) { return (pos + 63) & ~uint64_t(63); }
+
+// the narrowest vertex id width, in bytes, that holds the ids of n vertices and NoId
+uint32_t VertexIdBytesFor(uint64_t n) { return n < UINT16_MAX ? 2 : n < UINT32_MAX ? 4 : 8; }
+
+// vertex ids sorted by decreasing degree, ties broken by id
+std::vector<uint32_t> DegreeOrder(const Graph &graph)
+{
+    std::vector<uint32_t> order(graph.n);
+    for (uint32_t v = 0; v < graph.n; ++v)
+    {
+        order[v] = v;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&graph](uint32_t a, uint32_t b) { return graph.Degree(a) > graph.Degree(b); });
+    return order;
+}
+
+// writes count values as Stored integers, converting a block at a time
+template <typename Stored, typename T>
+void WriteStoredIds(std::ofstream &OutputFile, const T *values, uint64_t count)
+{
+    if (sizeof(Stored) == sizeof(T))
+    {
+        OutputFile.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(count * sizeof(T)));
+        return;
+    }
+    std::vector<Stored> block;
+    for (uint64_t first = 0; first < count; first += block.size())
+    {
+        block.assign(values + first, values + std::min(count, first + (uint64_t(1) << 16)));
+        OutputFile.write(reinterpret_cast<const char *>(block.data()), static_cast<std::streamsize>(block.size() * sizeof(Stored)));
+    }
+}
+
+template <typename T>
+void WriteStoredIds(std::ofstream &OutputFile, const T *values, uint64_t count, uint32_t bytes)
+{
+    if (bytes == 2)
+        WriteStoredIds<uint16_t>(OutputFile, values, count);
+    else if (bytes == 4)
+        WriteStoredIds<uint32_t>(OutputFile, values, count);
+    else
+        WriteStoredIds<uint64_t>(OutputFile, values, count);
+}
+
+// VertexIdBytes = 0 picks the narrowest width for the graph; a width too narrow for it is widened
+bool WriteBinaryGraph(const Graph &graph, const char *path, bool WithPermutation, uint32_t VertexIdBytes = 0)
+{
+    std::ofstream OutputFile(path, std::ios::binary | std::ios::trunc);
+    if (!OutputFile.is_open())
+        return false;
+
+    BinaryGraphHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_GRAPH_MAGIC, sizeof(header.magic));
+    header.version = BINARY_GRAPH_VERSION;
+    header.ByteOrderMark = BINARY_GRAPH_BYTE_ORDER_MARK;
+    header.VertexIdBytes = std::max(VertexIdBytes, VertexIdBytesFor(graph.n));
+    header.flags = (graph.IsUndirected ? BINARY_GRAPH_UNDIRECTED : 0) | (WithPermutation ? BINARY_GRAPH_HAS_PERMUTATION : 0) |
+                   (header.VertexIdBytes == 8 ? BINARY_GRAPH_WIDE_OFFSETS : 0);
+    header.n = graph.n;
+    header.m = graph.AdjArray.size();
+    header.OffsetsPos = AlignTo64(sizeof(header));
+    header.NeighboursPos = AlignTo64(header.OffsetsPos + (header.n + 1) * header.OffsetBytes());
+    header.PermutationPos = WithPermutation ? AlignTo64(header.NeighboursPos + header.m * header.VertexIdBytes) : 0;
+
+    auto PadTo = [&OutputFile](uint64_t pos) {
+        static const char zeros[64] = {};
+        auto cur = static_cast<uint64_t>(OutputFile.tellp());
+        OutputFile.write(zeros, static_cast<std::streamsize>(pos - cur)); // padding up to the alignment
+    };
+    OutputFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    PadTo(header.OffsetsPos);
+    WriteStoredIds(OutputFile, graph.AdjOffsets.data(), header.n + 1, header.OffsetBytes());
+    PadTo(header.NeighboursPos);
+    WriteStoredIds(OutputFile, graph.AdjArray.data(), header.m, header.VertexIdBytes);
+    if (WithPermutation)
+    {
+        auto order = DegreeOrder(graph);
+        PadTo(header.PermutationPos);
+        WriteStoredIds(OutputFile, order.data(), header.n, header.VertexIdBytes);
+    }
+    return OutputFile.good();
+}
+
+void ReportBadBinaryGraph(const char *path, const char *reason)
+{
+    Fail("Error: " + std::string(path) + ": not a usable binary graph (" + reason + ")");
+}
+
+// checks what can be checked of a binary graph from its header alone
+void CheckBinaryGraphHeader(const char *path, const BinaryGraphHeader &header)
+{
+    if (memcmp(header.magic, BINARY_GRAPH_MAGIC, sizeof(header.magic)) != 0)
+        ReportBadBinaryGraph(path, "bad magic");
+    if (header.ByteOrderMark != BINARY_GRAPH_BYTE_ORDER_MARK)
+        ReportBadBinaryGraph(path, "written with a different byte order");
+    bool version1 = header.version == 1 && header.VertexIdBytes == 4 && !(header.flags & BINARY_GRAPH_WIDE_OFFSETS);
+    bool version2 = header.version == 2 && (header.VertexIdBytes == 2 || header.VertexIdBytes == 4 || header.VertexIdBytes == 8);
+    if (!version1 && !version2)
+        ReportBadBinaryGraph(path, "unsupported version");
+}
+
+// the header of the binary graph at path, checked
+BinaryGraphHeader ReadBinaryGraphHeader(const char *path)
+{
+    MappedFile file;
+    MapInputFile(file, path);
+    BinaryGraphHeader header;
+    if (file.size < sizeof(header))
+        ReportBadBinaryGraph(path, "truncated header");
+    memcpy(&header, file.data, sizeof(header));
+    CheckBinaryGraphHeader(path, header);
+    return header;
+}
+
+// element i of an array of bytes-wide integers
+uint64_t StoredId(const char *data, uint32_t bytes, uint64_t i)
+{
+    if (bytes == 2)
+    {
+        uint16_t value;
+        memcpy(&value, data + i * 2, 2);
+        return value;
+    }
+    if (bytes == 4)
+    {
+        uint32_t value;
+        memcpy(&value, data + i * 4, 4);
+        return value;
+    }
+    uint64_t value;
+    memcpy(&value, data + i * 8, 8);
+    return value;
+}
+
+// Checks that the arrays placed by the header of a binary graph lie within its file of size bytes, and that the
+// offsets start at 0 and end at m, before anything reads them. The sizes are bounded by division, so that a forged
+// n or m cannot wrap a product around into a small size.
+void CheckBinaryGraphLayout(const char *path, const BinaryGraphHeader &header, const char *data, uint64_t size)
+{
+    auto fits = [size](uint64_t pos, uint64_t count, uint32_t bytes) { return pos % 64 == 0 && pos <= size && count <= (size - pos) / bytes; };
+    uint32_t IdBytes = header.VertexIdBytes, OffsetBytes = header.OffsetBytes();
+    if (header.n == UINT64_MAX || !fits(header.OffsetsPos, header.n + 1, OffsetBytes) || !fits(header.NeighboursPos, header.m, IdBytes) ||
+        ((header.flags & BINARY_GRAPH_HAS_PERMUTATION) && !fits(header.PermutationPos, header.n, IdBytes)))
+        ReportBadBinaryGraph(path, "truncated arrays");
+
+    const char *offsets = data + header.OffsetsPos;
+    if (StoredId(offsets, OffsetBytes, 0) != 0 || StoredId(offsets, OffsetBytes, header.n) != header.m)
+        ReportBadBinaryGraph(path, "inconsistent offsets");
+}
+
+// Uses the count Stored integers at data as array: borrowed as they are if Stored is Id, converted otherwise.
+template <typename Stored, typename Id>
+void LoadStoredIds(GraphArray<Id> &array, const char *data, uint64_t count)
+{
+    auto stored = reinterpret_cast<const Stored *>(data);
+    if (std::is_same<Stored, Id>::value)
+        array.Borrow(reinterpret_cast<const Id *>(stored), count);
+    else
+        array.Adopt(std::vector<Id>(stored, stored + count));
+}
+
+template <typename Id>
+void LoadStoredIds(GraphArray<Id> &array, const char *data, uint32_t bytes, uint64_t count)
+{
+    if (bytes == 2)
+        LoadStoredIds<uint16_t>(array, data, count);
+    else if (bytes == 4)
+        LoadStoredIds<uint32_t>(array, data, count);
+    else
+        LoadStoredIds<uint64_t>(array, data, count);
+}
+
+// Checks the arrays of a binary graph whose header has passed, before anything indexes with them: offsets that
+// never decrease, neighbours below n, a permutation that lists every vertex once and, in an undirected graph,
+// neighbour lists that are strictly increasing, free of self-loops and symmetric. One pass over the arrays; the
+// symmetry takes a cursor per vertex.
+template <typename Id, typename Offset>
+void CheckStoredArrays(const char *path, const BinaryGraphHeader &header, const char *data)
+{
+    auto offsets = reinterpret_cast<const Offset *>(data + header.OffsetsPos);
+    auto neighbours = reinterpret_cast<const Id *>(data + header.NeighboursPos);
+    const uint64_t n = header.n;
+    for (uint64_t v = 0; v < n; ++v)
+    {
+        if (offsets[v + 1] < offsets[v])
+            ReportBadBinaryGraph(path, "decreasing offsets");
+    }
+
+    // as v runs up, it is matched with the entry v in the list of each larger neighbour w, so the smaller
+    // neighbours of w are matched in increasing order, and come first in its sorted list; next[w] is the first
+    // entry of w not matched yet, and must be past them by the time v reaches w
+    bool undirected = (header.flags & BINARY_GRAPH_UNDIRECTED) != 0;
+    std::vector<Offset> next;
+    if (undirected)
+        next.assign(offsets, offsets + n);
+    for (uint64_t v = 0; v < n; ++v)
+    {
+        if (undirected && next[v] < offsets[v + 1] && neighbours[next[v]] < v)
+            ReportBadBinaryGraph(path, "asymmetric neighbour lists in an undirected graph");
+        for (uint64_t i = offsets[v]; i < offsets[v + 1]; ++i)
+        {
+            uint64_t w = neighbours[i];
+            if (w >= n)
+                ReportBadBinaryGraph(path, "neighbour out of range");
+            if (!undirected)
+                continue;
+            if (w == v)
+                ReportBadBinaryGraph(path, "self-loop in an undirected graph");
+            if (i > offsets[v] && w <= neighbours[i - 1])
+                ReportBadBinaryGraph(path, "unsorted or repeated neighbours in an undirected graph");
+            if (w > v && (next[w] == offsets[w + 1] || neighbours[next[w]++] != v))
+                ReportBadBinaryGraph(path, "asymmetric neighbour lists in an undirected graph");
+        }
+    }
+
+    if (header.flags & BINARY_GRAPH_HAS_PERMUTATION)
+    {
+        auto permutation = reinterpret_cast<const Id *>(data + header.PermutationPos);
+        BasicVertexFlags<uint64_t> listed(n);
+        for (uint64_t x = 0; x < n; ++x)
+        {
+            if (permutation[x] >= n || !listed.TestAndSet(permutation[x]))
+                ReportBadBinaryGraph(path, "permutation out of range or repeated");
+        }
+    }
+}
+
+void CheckBinaryGraphArrays(const char *path, const BinaryGraphHeader &header, const char *data)
+{
+    bool wide = header.OffsetBytes() == 8;
+    if (header.VertexIdBytes == 2)
+        wide ? CheckStoredArrays<uint16_t, uint64_t>(path, header, data) : CheckStoredArrays<uint16_t, uint32_t>(path, header, data);
+    else if (header.VertexIdBytes == 4)
+        wide ? CheckStoredArrays<uint32_t, uint64_t>(path, header, data) : CheckStoredArrays<uint32_t, uint32_t>(path, header, data);
+    else
+        wide ? CheckStoredArrays<uint64_t, uint64_t>(path, header, data) : CheckStoredArrays<uint64_t, uint32_t>(path, header, data);
+}
+
+// Maps a .bcsr file and uses the mapping as the graph's CSR arrays, without copying them when the file's
+// widths are VertexId and EdgeId; arrays of other widths are converted, as long as the graph fits the ids.
+// The arrays are checked first (CheckBinaryGraphArrays), so a corrupt file is reported rather than indexed out of
+// bounds; that pass pages the whole file in.
+template <typename VertexId = uint32_t, typename EdgeId = uint32_t>
+BasicGraph<VertexId, EdgeId> LoadBinaryGraph(const char *path)
+{
+    auto file = std::make_shared<MappedFile>();
+    MapInputFile(*file, path);
+
+    BinaryGraphHeader header;
+    if (file->size < sizeof(header))
+        ReportBadBinaryGraph(path, "truncated header");
+    memcpy(&header, file->data, sizeof(header));
+    CheckBinaryGraphHeader(path, header);
+    if (header.n >= NoId<VertexId> || header.m > std::numeric_limits<EdgeId>::max())
+    {
+        std::string reason = "too large for " + std::to_string(8 * sizeof(VertexId)) + "-bit ids and " +
+                             std::to_string(8 * sizeof(EdgeId)) + "-bit offsets";
+        ReportBadBinaryGraph(path, reason.c_str());
+    }
+
+    CheckBinaryGraphLayout(path, header, file->data, file->size);
+    CheckBinaryGraphArrays(path, header, file->data);
+
+    uint32_t IdBytes = header.VertexIdBytes, OffsetBytes = header.OffsetBytes();
+    const char *offsets = file->data + header.OffsetsPos;
+
+    BasicGraph<VertexId, EdgeId> graph(static_cast<VertexId>(header.n));
+    LoadStoredIds(graph.AdjOffsets, offsets, OffsetBytes, header.n + 1);
+    LoadStoredIds(graph.AdjArray, file->data + header.NeighboursPos, IdBytes, header.m);
+    graph.m = static_cast<EdgeId>(header.m);
+    if (header.flags & BINARY_GRAPH_HAS_PERMUTATION)
+        LoadStoredIds(graph.DegreePermutation, file->data + header.PermutationPos, IdBytes, header.n);
+    graph.IsUndirected = (header.flags & BINARY_GRAPH_UNDIRECTED) != 0;
+    if (graph.AdjOffsets.IsBorrowed() || graph.AdjArray.IsBorrowed() || graph.DegreePermutation.IsBorrowed())
+        graph.Mapping = file;
+    return graph;
+}
+
+#endif
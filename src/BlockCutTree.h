@@ -0,0 +1,68 @@
+#ifndef BLOCK_CUT_TREE_H
+#define BLOCK_CUT_TREE_H
+
+#include "utils.h"
+
+// The block-cut tree (a forest for a disconnected graph): node b < NumBlocks is biconnected component b,
+// node NumBlocks + i is the articulation point CutVertices[i], and each articulation point is linked to
+// every component it belongs to. Stored in CSR form like Graph.
+struct BlockCutTree
+{
+    uint32_t NumBlocks = 0;
+    std::vector<uint32_t> CutVertices; // = result.ArticulationPoints
+    std::vector<uint32_t> CutIndex;    // CutIndex[v] = i when v = CutVertices[i], UINT32_MAX otherwise
+    std::vector<uint32_t> AdjOffsets{0};
+    std::vector<uint32_t> AdjArray;
+
+    uint32_t NumNodes() const { return static_cast<uint32_t>(AdjOffsets.size() - 1); }
+    NeighbourRange Adj(uint32_t node) const { return {AdjArray.data() + AdjOffsets[node], AdjArray.data() + AdjOffsets[node + 1]}; }
+};
+
+// Builds the block-cut tree from result.EdgeComponent in O(n + m), without touching any component lists.
+void BuildBlockCutTree(const Graph &graph, const BiconnectivityResult &result, BlockCutTree &tree)
+{
+    tree.NumBlocks = result.NumComponents();
+    tree.CutVertices = result.ArticulationPoints;
+    tree.CutIndex.assign(graph.n, UINT32_MAX);
+    for (uint32_t i = 0; i < tree.CutVertices.size(); ++i)
+    {
+        tree.CutIndex[tree.CutVertices[i]] = i;
+    }
+
+    // the distinct components around each articulation point
+    std::vector<std::pair<uint32_t, uint32_t>> links; // (block, cut node)
+    std::vector<uint32_t> SeenBy(tree.NumBlocks, UINT32_MAX);
+    for (uint32_t i = 0; i < tree.CutVertices.size(); ++i)
+    {
+        uint32_t v = tree.CutVertices[i];
+        for (uint32_t e = graph.AdjOffsets[v]; e < graph.AdjOffsets[v + 1]; ++e)
+        {
+            uint32_t block = result.EdgeComponent[e];
+            if (SeenBy[block] == i)
+                continue;
+            SeenBy[block] = i;
+            links.push_back({block, tree.NumBlocks + i});
+        }
+    }
+
+    uint32_t NumNodes = tree.NumBlocks + static_cast<uint32_t>(tree.CutVertices.size());
+    tree.AdjOffsets.assign(NumNodes + 1, 0);
+    for (auto &link : links)
+    {
+        ++tree.AdjOffsets[link.first + 1];
+        ++tree.AdjOffsets[link.second + 1];
+    }
+    for (uint32_t node = 0; node < NumNodes; ++node)
+    {
+        tree.AdjOffsets[node + 1] += tree.AdjOffsets[node];
+    }
+    tree.AdjArray.resize(links.size() * 2);
+    std::vector<uint32_t> fill(tree.AdjOffsets.begin(), tree.AdjOffsets.end() - 1);
+    for (auto &link : links)
+    {
+        tree.AdjArray[fill[link.first]++] = link.second;
+        tree.AdjArray[fill[link.second]++] = link.first;
+    }
+}
+
+#endif
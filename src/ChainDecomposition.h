@@ -0,0 +1,157 @@
+#ifndef CHAIN_DECOMPOSITION_H
+#define CHAIN_DECOMPOSITION_H
+
+#include "utils.h"
+
+// The chains of a chain decomposition, stored back to back as vertex sequences.
+// Chain c is ChainVertices[ChainStart[c] ... ChainStart[c + 1] - 1]; its first edge is a back edge from the
+// first vertex down to the second, every further edge is the tree edge from a vertex up to its parent.
+struct Chains
+{
+    std::vector<uint32_t> ChainStart{0};
+    std::vector<uint32_t> ChainVertices;
+
+    uint32_t NumChains() const { return static_cast<uint32_t>(ChainStart.size() - 1); }
+    uint32_t First(uint32_t c) const { return ChainVertices[ChainStart[c]]; }
+    uint32_t Last(uint32_t c) const { return ChainVertices[ChainStart[c + 1] - 1]; }
+    bool IsCycle(uint32_t c) const { return First(c) == Last(c); }
+};
+
+// Schmidt's chain decomposition in O(n + m), giving articulation points, bridges and biconnected components.
+//  1. an iterative DFS fills graph.State and graph.DFSForest and lists the vertices in preorder
+//  2. the vertices are taken in preorder and each back edge v-u out of v (u a descendant of v) starts a chain:
+//     the back edge, then tree edges up from u until a vertex already on a chain
+// Scanning the adjacency lists in preorder hands out the back edges bucketed by the discovery time of their
+// upper end, so no sort is needed; the visited and on-a-chain flags are bitmaps and the adjacency lists
+// are never modified.
+// A tree edge on no chain is a bridge. A vertex is an articulation point when it is the end of a bridge and
+// has another edge, or when it starts a cycle while it is already on a chain (a cycle through a new vertex
+// starts a new 2-edge-connected piece instead).
+// Every chain lies within one biconnected component: a cycle opens a new one, a path joins the component of
+// the tree edge above the vertex it ends at, and a bridge is a component of its own. The chain labels the
+// tree edges it walks up, and BuildComponentLists lays out the edge lists from these labels.
+// The graph must be undirected and simple, see MakeUndirected.
+void ChainDecomposition(Graph &graph, Chains &chains, BiconnectivityResult &result)
+{
+    auto &state = graph.State;
+    state.Reset(graph.n);
+    graph.DFSForest.clear();
+    chains = Chains();
+    result.Clear();
+
+    // 1. DFS
+    ScopedPhase phase("chain dfs");
+    struct Frame
+    {
+        uint32_t v;
+        uint32_t next; // position in AdjArray of the next edge of v to look at
+    };
+    std::vector<Frame> stack;
+    std::vector<uint32_t> order; // vertices in preorder
+    order.reserve(graph.n);
+    uint32_t DiscoveryTime = 1;
+    uint64_t EdgesScanned = 0;
+    size_t StackHighWater = 0;
+    for (uint32_t root = 0; root < graph.n; ++root)
+    {
+        if (state.DiscoveryTime[root] != UINT32_MAX)
+            continue;
+
+        graph.DFSForest.push_back(Tree(root)); // create a new tree
+        auto &curTree = graph.DFSForest.back();
+        uint32_t CurTreeNum = static_cast<uint32_t>(graph.DFSForest.size() - 1);
+
+        state.DiscoveryTime[root] = DiscoveryTime++;
+        state.TreeNum[root] = CurTreeNum;
+        ++curTree.NumVertices;
+        order.push_back(root);
+        stack.push_back({root, graph.AdjOffsets[root]});
+        StackHighWater = std::max<size_t>(StackHighWater, 1);
+        while (!stack.empty())
+        {
+            auto &top = stack.back();
+            if (top.next == graph.AdjOffsets[top.v + 1])
+            {
+                stack.pop_back();
+                continue;
+            }
+            uint32_t v = top.v;
+            uint32_t w = graph.AdjArray[top.next++];
+            ++EdgesScanned;
+            if (state.DiscoveryTime[w] != UINT32_MAX)
+                continue;
+
+            // tree edge v-w
+            state.AddChild(v, w);
+            state.DiscoveryTime[w] = DiscoveryTime++;
+            state.TreeNum[w] = CurTreeNum;
+            ++curTree.NumVertices;
+            order.push_back(w);
+            stack.push_back({w, graph.AdjOffsets[w]}); // invalidates top
+            StackHighWater = std::max(StackHighWater, stack.size());
+        }
+    }
+
+    CountEvent("vertices visited", graph.n);
+    CountEvent("edges scanned", EdgesScanned);
+    RecordMaximum("stack high-water", StackHighWater);
+
+    // 2. chains
+    phase.Next("chains");
+    VertexFlags visited(graph.n);
+    VertexFlags InChain(graph.n); // the tree edge to the parent lies on a chain
+    auto &IsArticulation = state.IsArticulation;
+    std::vector<uint32_t> label(graph.n, UINT32_MAX); // component of the tree edge to the parent
+    uint32_t NumComponents = 0;
+    for (auto v : order)
+    {
+        for (auto u : graph.Adj(v))
+        {
+            // only back edges seen from their upper end
+            if (state.DiscoveryTime[u] < state.DiscoveryTime[v] || state.Parent[u] == v)
+                continue;
+
+            bool WasVisited = !visited.TestAndSet(v);
+            chains.ChainVertices.push_back(v);
+            uint32_t x = u;
+            while (!visited[x])
+            {
+                chains.ChainVertices.push_back(x);
+                visited.Set(x);
+                InChain.Set(x);
+                x = state.Parent[x];
+            }
+            chains.ChainVertices.push_back(x);
+            chains.ChainStart.push_back(static_cast<uint32_t>(chains.ChainVertices.size()));
+
+            if (x == v && WasVisited)
+                IsArticulation.Set(v);
+            uint32_t component = x == v ? NumComponents++ : label[x];
+            uint32_t c = chains.NumChains() - 1;
+            for (uint32_t i = chains.ChainStart[c] + 1; i + 1 < chains.ChainStart[c + 1]; ++i)
+            {
+                label[chains.ChainVertices[i]] = component;
+            }
+        }
+    }
+
+    for (auto v : order)
+    {
+        uint32_t p = state.Parent[v];
+        if (p == UINT32_MAX || InChain[v])
+            continue;
+        result.Bridges.push_back({std::min(p, v), std::max(p, v)});
+        label[v] = NumComponents++;
+        if (graph.Degree(p) > 1)
+            IsArticulation.Set(p);
+        if (graph.Degree(v) > 1)
+            IsArticulation.Set(v);
+    }
+    IsArticulation.ForEach([&result](uint32_t v) { result.ArticulationPoints.push_back(v); });
+    std::sort(result.Bridges.begin(), result.Bridges.end());
+    CountEvent("chains", chains.NumChains());
+    phase.Next("component lists");
+    BuildComponentLists(graph, state.Parent, state.DiscoveryTime, label, result);
+}
+
+#endif
@@ -0,0 +1,213 @@
+'''
+Usage: python3 src/Check.py [directory of the tarjan, schmidt and gengraph binaries]
+
+Runs every engine on the sample inputs in data/ and on gengraph families, and diffs their results:
+
+1. tarjan --engine=linear --output=full is the reference for each graph.
+2. The parallel engine, --reorder, the semi-external engine and the linear engine on .bcsr files of every id width
+   must print exactly the same. schmidt --engine=chain must too, once its chains and block-cut tree are left out.
+3. schmidt --engine=legacy must find the same articulation points and bridges. tarjan --engine=legacy prints
+   nothing and only has to finish.
+4. --updates deletes and inserts a few edges in two batches, and must end with what tarjan prints for the updated
+   graph.
+5. On small graphs the articulation points and bridges are checked by brute force against the reference, and the
+   families whose answer is known (path, grid, cliques) are checked against it.
+
+Prints one line per graph and exits with 1 if anything differs.
+'''
+
+import glob
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+BRUTE_FORCE_EDGES = 1000  # graphs with more edges skip the brute-force check
+DYNAMIC_EDGES = 50000     # and the --updates check
+UPDATES = 50              # per batch; a deletion within a block analyses the whole block again
+
+FAMILIES = [
+    'path:1', 'path:2', 'path:200',
+    'grid:1:30', 'grid:2:2', 'grid:25:40', 'grid:12:15',
+    'cliques:1:5', 'cliques:12:2:3', 'cliques:30:6:7',
+    'random:300:280:1', 'random:400:900:2', 'random:5000:5200:3',
+    'rmat:12:20000:4',
+]
+
+
+def Run(args):
+    result = subprocess.run(args, stdout=subprocess.PIPE, stderr=subprocess.PIPE, universal_newlines=True)
+    if result.returncode != 0:
+        raise RuntimeError(' '.join(args) + ' exited with ' + str(result.returncode) + ': ' + result.stdout + result.stderr)
+    return result.stdout
+
+
+def ParseResult(output):
+    '''The articulation points, bridges and edges of a --output=full listing.'''
+    points, bridges, edges = set(), set(), []
+    for line in output.split('\n'):
+        label, _, rest = line.partition(':')
+        if label == 'Articulation points':
+            points = set(int(v) for v in rest.split())
+        elif label == 'Bridges':
+            bridges = set(Edge(e) for e in rest.replace(',', ' ').split())
+        elif label.startswith('Component '):
+            edges += [Edge(e) for e in rest.split()]
+    return points, bridges, edges
+
+
+def Edge(text):
+    u, v = (int(x) for x in text.split('-'))
+    return (min(u, v), max(u, v))
+
+
+def WithoutChains(output):
+    '''schmidt --output=full without the chains and the block-cut tree, as tarjan prints it.'''
+    lines = output.split('\n')
+    if 'Block-cut tree:' in lines:
+        lines = lines[:lines.index('Block-cut tree:')] + ['']
+    return '\n'.join(line for line in lines if not line.startswith('Chain '))
+
+
+def WriteIn(path, n, edges):
+    adjacency = [[] for _ in range(n)]
+    for u, v in edges:
+        adjacency[u].append(v)
+    with open(path, 'w') as f:
+        f.write(str(n) + '\n')
+        for neighbours in adjacency:
+            f.write(' '.join(map(str, neighbours)) + '\n')
+
+
+def CountComponents(n, edges, SkipVertex=None, SkipEdge=None):
+    parent = list(range(n))
+
+    def Find(x):
+        while parent[x] != x:
+            parent[x] = parent[parent[x]]
+            x = parent[x]
+        return x
+
+    count = n - (SkipVertex is not None)
+    for e in edges:
+        if e == SkipEdge or SkipVertex in e:
+            continue
+        a, b = Find(e[0]), Find(e[1])
+        if a != b:
+            parent[a] = b
+            count -= 1
+    return count
+
+
+def BruteForce(n, edges):
+    '''The articulation points and bridges by definition: removing them leaves more connected components.'''
+    whole = CountComponents(n, edges)
+    touched = set(v for e in edges for v in e)
+    points = set(v for v in touched if CountComponents(n, edges, SkipVertex=v) > whole)
+    bridges = set(e for e in edges if CountComponents(n, edges, SkipEdge=e) > whole)
+    return points, bridges
+
+
+def KnownAnswer(family, n, points, bridges, output):
+    '''Why the result of a generated family with a known answer is wrong, or None.'''
+    p = [int(x) for x in family.split(':')[1:]]
+    if family.startswith('path:'):
+        expected = (set(range(1, n - 1)), set((v, v + 1) for v in range(n - 1)))
+    elif family.startswith('grid:'):
+        if min(p[0], p[1]) == 1:
+            expected = (set(range(1, n - 1)), None)
+        else:
+            expected = (set(), set())
+    elif family.startswith('cliques:'):
+        if 'Biconnected components: ' + str(p[0]) + '\n' not in output:
+            return 'not ' + str(p[0]) + ' biconnected components'
+        expected = (None, set() if p[1] > 2 else None)
+    else:
+        return None
+    if expected[0] is not None and points != expected[0]:
+        return 'wrong articulation points'
+    if expected[1] is not None and bridges != expected[1]:
+        return 'wrong bridges'
+    return None
+
+
+def Updates(n, edges, rng):
+    '''Two batches: up to UPDATES edges deleted, then as many random edges inserted. Returns the file and the
+    edges left.'''
+    deleted = set(rng.sample(edges, min(len(edges) // 2, UPDATES)))
+    inserted = [(rng.randrange(n), rng.randrange(n)) for _ in range(len(deleted))]
+    lines = ['- %d %d' % e for e in sorted(deleted)] + [''] + ['+ %d %d' % e for e in inserted]
+    left = set(e for e in edges if e not in deleted) | set((min(e), max(e)) for e in inserted if e[0] != e[1])
+    return '\n'.join(lines) + '\n', sorted(left)
+
+
+def CheckGraph(name, path, bin, work, family=None):
+    tarjan, schmidt = os.path.join(bin, 'tarjan'), os.path.join(bin, 'schmidt')
+    failures = []
+
+    def Expect(what, output, reference):
+        if output != reference:
+            failures.append(what)
+
+    reference = Run([tarjan, '--output=full', path])
+    points, bridges, edges = ParseResult(reference)
+    Expect('parallel', Run([tarjan, '--engine=parallel', '--threads=4', '--output=full', path]), reference)
+    Expect('reorder', Run([tarjan, '--reorder=rcm', '--output=full', path]), reference)
+    Expect('schmidt chain', WithoutChains(Run([schmidt, '--output=full', path])), reference)
+    legacy = ParseResult(Run([schmidt, '--engine=legacy', '--output=bridges', path]))
+    Expect('schmidt legacy', legacy[:2], (points, bridges))
+    Run([tarjan, '--engine=legacy', path])
+
+    # "Wrote graph.bcsr: n vertices, ..."
+    binary = os.path.join(work, 'graph.bcsr')
+    n = int(Run([tarjan, 'convert', path, binary]).split(': ')[1].split()[0])
+    Expect('semi-external', Run([tarjan, '--engine=semi-external', '--output=full', binary]), reference)
+    for IdBytes in ('2', '4', '8'):
+        if IdBytes == '2' and n >= 65535:
+            continue
+        Run([tarjan, 'convert', path, binary, '--id-bytes=' + IdBytes])
+        Expect(IdBytes + '-byte .bcsr', Run([tarjan, '--output=full', binary]), reference)
+    os.remove(binary)
+
+    if len(edges) <= DYNAMIC_EDGES:
+        updates, left = Updates(n, edges, random.Random(name))
+        UpdatesPath, UpdatedPath = os.path.join(work, 'updates.txt'), os.path.join(work, 'updated.in')
+        with open(UpdatesPath, 'w') as f:
+            f.write(updates)
+        WriteIn(UpdatedPath, n, left)
+        dynamic = Run([tarjan, '--output=full', '--updates=' + UpdatesPath, path])
+        dynamic = '\n'.join(line for line in dynamic.split('\n') if not line.startswith('Batch '))
+        Expect('dynamic', dynamic, Run([tarjan, '--output=full', UpdatedPath]))
+
+    if len(edges) <= BRUTE_FORCE_EDGES:
+        Expect('brute force', BruteForce(n, edges), (points, bridges))
+    if family is not None:
+        wrong = KnownAnswer(family, n, points, bridges, reference)
+        if wrong is not None:
+            failures.append(wrong)
+
+    print(('ok   ' if not failures else 'FAIL ') + name + ''.join(' [' + f + ']' for f in failures))
+    return not failures
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    bin = sys.argv[1] if len(sys.argv) > 1 else root
+    inputs = sorted(glob.glob(os.path.join(root, 'data', '**', '*.in'), recursive=True))
+    inputs += sorted(glob.glob(os.path.join(root, 'data', '**', '*.mtx'), recursive=True))
+    ok = True
+    with tempfile.TemporaryDirectory() as work:
+        for path in inputs:
+            ok &= CheckGraph(os.path.relpath(path, root), path, bin, work)
+        for family in FAMILIES:
+            path = os.path.join(work, 'family.in')
+            Run([os.path.join(bin, 'gengraph'), family, path])
+            ok &= CheckGraph(family, path, bin, work, family)
+    if not ok:
+        sys.exit('Check failed')
+    print('All checks passed')
+
+
+if __name__ == '__main__':
+    main()
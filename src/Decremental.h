@@ -0,0 +1,193 @@
+#ifndef DECREMENTAL_H
+#define DECREMENTAL_H
+
+#include "Incremental.h"
+#include "TarjanHopcroft.h"
+
+// Edge deletions on the block-cut forest of IncrementalBiconnectivity, by recomputation. This is not a
+// polylogarithmic decremental structure (such as that of Holm, de Lichtenberg and Thorup): a deletion recomputes
+// the part of the forest that it can change, and no more.
+// - a bridge simply disappears and its tree splits in two. Both halves are searched at once until the smaller
+//   one is exhausted, and it takes a new tree id: O(edges of the smaller half) per deletion.
+// - any other block is searched from the lost edge, analysed again on its own with TarjanHopcroft and replaced
+//   by the blocks it falls into: O(edges at the vertices of the block) per deletion, however few of them change.
+// So deletions within one huge block cost as much as a fresh run over that block each time; Rebuild, a fresh run
+// over the whole graph as it is now, bounds what a batch of them has to cost (see DynamicBiconnectivity.h).
+struct DecrementalBiconnectivity : IncrementalBiconnectivity
+{
+    Graph Rebuilt{0};              // the graph as of the last Rebuild, base from then on
+    std::vector<uint32_t> LocalId; // scratch for SplitBlock
+
+    // Takes over the result and block-cut tree of graph in O(n + m).
+    void Build(const Graph &graph, const BiconnectivityResult &result, const BlockCutTree &tree)
+    {
+        IncrementalBiconnectivity::Build(graph, result, tree);
+        LocalId.assign(n, UINT32_MAX);
+    }
+
+    void DeleteEdge(uint32_t u, uint32_t v)
+    {
+        if (u == v || !HasEdge(u, v))
+            return;
+        uint32_t b = EdgeBlock(u, v);
+        RemoveFromEdges(u, v);
+        if (BlockEdges[b] == 1)
+            DeleteBridge(b, u, v);
+        else
+            SplitBlock(b, u);
+    }
+
+    // the number of edges now
+    uint64_t NumEdges() const { return base->AdjArray.size() / 2 - Deleted.size() + Inserted.size(); }
+
+    // What DeleteEdge(u, v) would re-analyse: the edges of the block that loses (u, v), or 0 if it is a bridge
+    // or no edge at all.
+    uint32_t DeletionCost(uint32_t u, uint32_t v)
+    {
+        if (u == v || !HasEdge(u, v))
+            return 0;
+        uint32_t b = EdgeBlock(u, v);
+        return BlockEdges[b] > 1 ? BlockEdges[b] : 0;
+    }
+
+    // Inserts or deletes (u, v) in the edges alone, leaving the forest as it was until the next Rebuild.
+    void EditEdge(uint32_t u, uint32_t v, bool Delete)
+    {
+        if (u == v || HasEdge(u, v) != Delete)
+            return;
+        if (Delete)
+            RemoveFromEdges(u, v);
+        else
+            AddToEdges(u, v);
+    }
+
+    // Analyses the graph as it is now from scratch and takes over the result, in O(n + m).
+    void Rebuild()
+    {
+        GraphBuilder builder(n, NumEdges());
+        for (uint32_t u = 0; u < n; ++u)
+        {
+            ForEachNeighbour(u, [&](uint32_t w) {
+                if (u < w)
+                    builder.AddEdge(u, w);
+            });
+        }
+        Graph graph = builder.Build();
+        BiconnectivityResult result;
+        TarjanHopcroft(graph, result);
+        BlockCutTree tree;
+        BuildBlockCutTree(graph, result, tree);
+        Rebuilt = std::move(graph); // base may be the old Rebuilt graph, so only now that it has been read
+        Build(Rebuilt, result, tree);
+    }
+
+  protected:
+    void RemoveFromEdges(uint32_t u, uint32_t v)
+    {
+        if (Inserted.erase(EdgeKey(u, v)) == 0)
+        {
+            Deleted.insert(EdgeKey(u, v));
+            return;
+        }
+        for (auto end : {std::make_pair(u, v), std::make_pair(v, u)})
+        {
+            auto &list = InsertedAdj[end.first];
+            *std::find(list.begin(), list.end(), end.second) = list.back();
+            list.pop_back();
+            if (list.empty())
+                InsertedAdj.erase(end.first);
+        }
+    }
+
+    // Removes bridge b, already gone from the edges, splitting its tree: the half below it becomes a tree of its
+    // own, and the smaller half, found by searching both at once, takes a new tree id.
+    void DeleteBridge(uint32_t b, uint32_t u, uint32_t v)
+    {
+        uint32_t below = Head[b] == u ? v : u;
+        ParentBlock[below] = UINT32_MAX;
+        LeaveBlock(u);
+        LeaveBlock(v);
+        --NumBridges;
+        --NumBlocks;
+
+        NextEpoch();
+        std::vector<uint32_t> halves[2] = {{u}, {v}};
+        VertexMark[u] = Epoch;
+        VertexMark[v] = Epoch + 1;
+        size_t next[2] = {0, 0};
+        int smaller = 0;
+        for (;; smaller = 1 - smaller)
+        {
+            auto &half = halves[smaller];
+            if (next[smaller] == half.size())
+                break;
+            ForEachNeighbour(half[next[smaller]++], [&](uint32_t w) {
+                if (VertexMark[w] != Epoch + smaller)
+                {
+                    VertexMark[w] = Epoch + smaller;
+                    half.push_back(w);
+                }
+            });
+        }
+        uint32_t old = TreeId[u];
+        uint32_t id = NewTreeId();
+        for (auto x : halves[smaller])
+        {
+            TreeId[x] = id;
+        }
+        TreeSize[id] = static_cast<uint32_t>(halves[smaller].size());
+        TreeSize[old] -= TreeSize[id];
+    }
+
+    // Replaces block b, which has lost its edge at u but stays connected, by the blocks it now falls into:
+    // collects its vertices and edges by searching from u, analyses them on their own and hangs the result
+    // below the head of b.
+    void SplitBlock(uint32_t b, uint32_t u)
+    {
+        std::vector<uint32_t> global{u};
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        LocalId[u] = 0;
+        for (size_t i = 0; i < global.size(); ++i)
+        {
+            uint32_t x = global[i];
+            ForEachNeighbour(x, [&](uint32_t w) {
+                if (EdgeBlock(x, w) != b)
+                    return;
+                if (LocalId[w] == UINT32_MAX)
+                {
+                    LocalId[w] = static_cast<uint32_t>(global.size());
+                    global.push_back(w);
+                }
+                if (x < w)
+                    edges.push_back({LocalId[x], LocalId[w]});
+            });
+        }
+
+        GraphBuilder builder(static_cast<uint32_t>(global.size()), edges.size());
+        builder.edges.swap(edges);
+        Graph local = builder.Build();
+        BiconnectivityResult found;
+        TarjanHopcroft(local, found);
+        BlockCutTree tree;
+        BuildBlockCutTree(local, found, tree);
+
+        uint32_t root = LocalId[Head[b]];
+        for (auto x : global)
+        {
+            LocalId[x] = UINT32_MAX;
+        }
+        --NumBlocks;
+        uint32_t first = AddBlocks(found);
+        for (uint32_t x = 0; x < local.n; ++x)
+        {
+            uint32_t cut = tree.CutIndex[x];
+            uint32_t count = cut != UINT32_MAX ? static_cast<uint32_t>(tree.Adj(tree.NumBlocks + cut).size()) : 1;
+            SetBlocksOf(global[x], BlocksOf[global[x]] - 1 + count);
+        }
+        std::vector<uint32_t> VertexOffsets, vertices;
+        ListBlockVertices(local, found, VertexOffsets, vertices);
+        HangTree(local, found, tree, VertexOffsets, vertices, first, global.data(), root);
+    }
+};
+
+#endif
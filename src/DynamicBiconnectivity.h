@@ -0,0 +1,115 @@
+#ifndef DYNAMIC_BICONNECTIVITY_H
+#define DYNAMIC_BICONNECTIVITY_H
+
+#include "Decremental.h"
+
+// Biconnectivity under edge insertions and deletions, answering "is v an articulation point?" in O(1) and
+// "is (u, v) a bridge?" in O(α(n)) amortised at any time.
+// Insertions are those of IncrementalBiconnectivity (Incremental.h) and cost near-constant amortised time each.
+// Deletions are those of DecrementalBiconnectivity (Decremental.h), which recomputes what a deletion can change:
+// they are not polylogarithmic, and a fully dynamic structure with polylogarithmic deletions is out of scope
+// here. What ApplyBatch does bound is the re-analysis within a batch, to the cost of analysing the graph twice:
+// once the blocks its deletions would re-analyse add up to more edges than the graph has, the rest of the batch
+// only edits the edges and the batch ends with a Rebuild.
+// The vertex set is fixed; repeated edges, self-loops and deletions of missing edges are ignored.
+
+struct EdgeUpdate
+{
+    uint32_t u, v;
+    bool Delete;
+};
+
+struct DynamicBiconnectivity : DecrementalBiconnectivity
+{
+    void ApplyBatch(const std::vector<EdgeUpdate> &batch)
+    {
+        uint64_t budget = NumEdges(), spent = 0;
+        bool deferred = false;
+        for (auto &update : batch)
+        {
+            if (!deferred && update.Delete)
+            {
+                spent += DeletionCost(update.u, update.v);
+                deferred = spent > budget;
+            }
+            if (deferred)
+                EditEdge(update.u, update.v, update.Delete);
+            else if (update.Delete)
+                DeleteEdge(update.u, update.v);
+            else
+                InsertEdge(update.u, update.v);
+        }
+        if (deferred)
+            Rebuild();
+    }
+
+    bool InSameBlock(uint32_t u, uint32_t v) { return u == v || EdgeBlock(u, v) != UINT32_MAX; }
+
+    // Lists in cuts, in order from u to w, the articulation points that separate u from w: the vertices strictly
+    // inside the path from u to w in the block-cut tree. False if u and w are not connected at all.
+    // O(length of the path) amortised.
+    bool Separators(uint32_t u, uint32_t w, std::vector<uint32_t> &cuts)
+    {
+        cuts.clear();
+        if (TreeId[u] != TreeId[w])
+            return false;
+        if (u == w)
+            return true;
+        bool MeetAtBlock;
+        uint32_t meet = WalkToMeeting(u, w, MeetAtBlock);
+        auto &up = WalkPath[0], &down = WalkPath[1];
+        for (size_t i = 0; i < up.size(); ++i)
+        {
+            if (i + 1 < up.size() || MeetAtBlock)
+                cuts.push_back(Head[up[i]]);
+        }
+        if (!MeetAtBlock && !up.empty() && !down.empty())
+            cuts.push_back(meet);
+        for (size_t i = down.size(); i-- > 0;)
+        {
+            if (i + 1 < down.size() || MeetAtBlock)
+                cuts.push_back(Head[down[i]]);
+        }
+        return true;
+    }
+};
+
+// Reads batches of updates: one per line, "u v" or "+ u v" to insert the edge (u, v) and "- u v" to delete it.
+// An empty line ends a batch.
+void LoadUpdateBatches(const char *path, uint32_t n, std::vector<std::vector<EdgeUpdate>> &batches)
+{
+    std::ifstream InputFile(path);
+    if (!InputFile.is_open())
+    {
+        cout << "Could not open " << path << "\n";
+        exit(1);
+    }
+    batches.assign(1, {});
+    std::string line;
+    for (uint64_t LineNum = 1; std::getline(InputFile, line); ++LineNum)
+    {
+        if (IsWhitespace(line))
+        {
+            if (!batches.back().empty())
+                batches.push_back({});
+            continue;
+        }
+        std::istringstream fields(line);
+        bool Delete = false;
+        fields >> std::ws;
+        if (fields.peek() == '+' || fields.peek() == '-')
+            Delete = fields.get() == '-';
+        int64_t u, v;
+        std::string rest;
+        if (!(fields >> u >> v) || (fields >> rest) || u < 0 || v < 0 || u >= n || v >= n)
+        {
+            cout << "Error: line " << LineNum << " of " << path << " is not an update \"[+|-] u v\" of vertices below " << n << "\n";
+            exit(1);
+        }
+        batches.back().push_back({static_cast<uint32_t>(u), static_cast<uint32_t>(v), Delete});
+    }
+    if (batches.back().empty())
+        batches.pop_back();
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include "BinaryGraph.h"
+#include "Generators.h"
+#include "MappedFile.h"
+#include "OutputWriter.h"
+#include "Timer.h"
+#include "utils.h"
+
+// Writes a generated graph family (see Generators.h) straight to an .in or .bcsr file.
+// Two passes over the family's edge stream: the first counts the edges of every vertex, the second puts each
+// edge at its final position in a writable mapping (the output file itself for .bcsr, an unlinked scratch file
+// for .in), so memory use stays O(n) however many edges there are. Each edge is stored once, under its first
+// endpoint; tarjan and schmidt add the reverse direction when they load the graph.
+
+void ReportOutputError(const char *path)
+{
+    cout << "Error: could not write " << path << "\n";
+    exit(1);
+}
+
+// the .in format: the number of vertices, then one line of neighbours per vertex
+void WriteAdjacencyText(const char *path, uint32_t n, const std::vector<uint64_t> &offsets, const uint32_t *neighbours)
+{
+    std::ofstream OutputFile(path, std::ios::trunc);
+    if (!OutputFile.is_open())
+        ReportOutputError(path);
+    {
+        OutputWriter out(OutputFile);
+        out << n << '\n';
+        for (uint32_t v = 0; v < n; ++v)
+        {
+            for (uint64_t i = offsets[v]; i < offsets[v + 1]; ++i)
+            {
+                if (i != offsets[v])
+                    out << ' ';
+                out << neighbours[i];
+            }
+            out << '\n';
+        }
+    }
+    OutputFile.close();
+    if (OutputFile.fail())
+        ReportOutputError(path);
+}
+
+int main(int argc, char *argv[])
+{
+    FamilySpec f;
+    if (argc != 3 || !ParseFamilySpec(argv[1], f) || (!EndsWith(argv[2], ".in") && !EndsWith(argv[2], ".bcsr")))
+    {
+        cout << "Usage: ./gengraph family:parameters output.in|output.bcsr\n";
+        cout << "Families: path:N, grid:R:C, random:N:M[:SEED], rmat:SCALE:M[:SEED], cliques:K:S[:SEED] (see Generators.h)\n";
+        exit(1);
+    }
+    const char *path = argv[2];
+    bool binary = EndsWith(path, ".bcsr");
+    Timer t;
+
+    // 1. count the edges of every vertex
+    std::vector<uint64_t> offsets(uint64_t(f.n) + 1, 0);
+    ForEachFamilyEdge(f, [&offsets](uint32_t u, uint32_t v) {
+        if (u != v)
+            ++offsets[u + 1];
+    });
+    for (uint32_t v = 0; v < f.n; ++v)
+    {
+        offsets[v + 1] += offsets[v];
+    }
+    uint64_t m = offsets[f.n];
+
+    // 2. place them
+    WritableMappedFile file;
+    uint32_t *neighbours;
+    if (binary)
+    {
+        BinaryGraphHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, BINARY_GRAPH_MAGIC, sizeof(header.magic));
+        header.version = BINARY_GRAPH_VERSION;
+        header.ByteOrderMark = BINARY_GRAPH_BYTE_ORDER_MARK;
+        header.flags = m > UINT32_MAX ? BINARY_GRAPH_WIDE_OFFSETS : 0; // one direction only, possibly with repeats
+        header.VertexIdBytes = sizeof(uint32_t);
+        header.n = f.n;
+        header.m = m;
+        header.OffsetsPos = AlignTo64(sizeof(header));
+        header.NeighboursPos = AlignTo64(header.OffsetsPos + (header.n + 1) * header.OffsetBytes());
+        if (!file.Create(path, header.NeighboursPos + m * sizeof(uint32_t)))
+            ReportOutputError(path);
+        memcpy(file.data, &header, sizeof(header));
+        if (header.OffsetBytes() == sizeof(uint64_t))
+        {
+            memcpy(file.data + header.OffsetsPos, offsets.data(), (header.n + 1) * sizeof(uint64_t));
+        }
+        else
+        {
+            auto BinaryOffsets = reinterpret_cast<uint32_t *>(file.data + header.OffsetsPos);
+            for (uint64_t v = 0; v <= f.n; ++v)
+            {
+                BinaryOffsets[v] = static_cast<uint32_t>(offsets[v]);
+            }
+        }
+        neighbours = reinterpret_cast<uint32_t *>(file.data + header.NeighboursPos);
+    }
+    else
+    {
+        std::string scratch = std::string(path) + ".tmp";
+        if (!file.Create(scratch.c_str(), m * sizeof(uint32_t)))
+            ReportOutputError(scratch.c_str());
+        unlink(scratch.c_str()); // the mapping keeps the space until it is closed
+        neighbours = reinterpret_cast<uint32_t *>(file.data);
+    }
+    std::vector<uint64_t> fill(offsets.begin(), offsets.end() - 1);
+    ForEachFamilyEdge(f, [&fill, neighbours](uint32_t u, uint32_t v) {
+        if (u != v)
+            neighbours[fill[u]++] = v;
+    });
+
+    if (!binary)
+        WriteAdjacencyText(path, f.n, offsets, neighbours);
+    file.Close();
+
+    cout << "Wrote " << path << ": " << f.n << " vertices, " << m << " edges in " << t.Stop() << " ms\n";
+    return 0;
+}
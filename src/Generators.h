@@ -0,0 +1,192 @@
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include <random>
+
+#include "utils.h"
+
+// Synthetic graph families, named by a spec "<family>:<parameters>":
+//   path:N                a path on N vertices (the deepest DFS possible)
+//   grid:R:C              an R x C grid, vertex r * C + c (road-like: planar, small degrees, large diameter)
+//   random:N:M[:SEED]     Erdos-Renyi G(N, M): M edges drawn uniformly
+//   rmat:SCALE:M[:SEED]   R-MAT (Kronecker) with the Graph500 quadrant probabilities, 2^SCALE vertices, M edges
+//   cliques:K:S[:SEED]    a tree of K cliques of S >= 2 vertices, each clique after the first sharing one vertex
+//                         with a random earlier clique; the shared vertices are exactly the articulation points
+// Every family is an edge stream: ForEachFamilyEdge calls emit(u, v) once per generated edge, the same edges in
+// the same order on every call, so writers can make two passes without storing the edges. Random families may
+// repeat edges or produce self-loops; GraphBuilder and MakeUndirected drop them.
+
+struct FamilySpec
+{
+    std::string family;
+    std::vector<uint64_t> p; // the numbers after the family name
+    uint32_t n = 0;          // number of vertices
+    uint64_t seed = 1;
+};
+
+// Reads the colon-separated numbers of a spec after its family name; false if any is malformed.
+bool ParseSpecNumbers(const char *p, std::vector<uint64_t> &numbers)
+{
+    numbers.clear();
+    while (*p == ':')
+    {
+        char *end;
+        ++p;
+        if (*p < '0' || *p > '9')
+            return false;
+        numbers.push_back(strtoull(p, &end, 10));
+        p = end;
+    }
+    return *p == '\0';
+}
+
+// Splits spec into its family and parameters and works out the number of vertices.
+// Returns false when spec names no family or has the wrong parameters.
+bool ParseFamilySpec(const std::string &spec, FamilySpec &f)
+{
+    size_t colon = spec.find(':');
+    if (colon == std::string::npos)
+        return false;
+    f.family = spec.substr(0, colon);
+    auto &p = f.p;
+    if (!ParseSpecNumbers(spec.c_str() + colon, p))
+        return false;
+    for (auto value : p)
+    {
+        if (value == 0 || value == ULLONG_MAX)
+            return false;
+    }
+
+    size_t NumParameters = f.family == "path" ? 1 : 2;
+    bool seeded = f.family == "random" || f.family == "rmat" || f.family == "cliques";
+    if (p.size() != NumParameters && !(seeded && p.size() == NumParameters + 1))
+        return false;
+    uint64_t n = UINT64_MAX;
+    if (f.family == "path" || f.family == "random")
+    {
+        n = p[0];
+    }
+    else if (f.family == "grid")
+    {
+        if (p[0] < UINT32_MAX && p[1] < UINT32_MAX)
+            n = p[0] * p[1];
+    }
+    else if (f.family == "rmat")
+    {
+        if (p[0] < 32)
+            n = uint64_t(1) << p[0];
+    }
+    else if (f.family == "cliques")
+    {
+        if (p[1] >= 2 && p[0] < UINT32_MAX && p[1] < UINT32_MAX)
+            n = p[1] + (p[0] - 1) * (p[1] - 1);
+    }
+    else
+    {
+        return false;
+    }
+    if (n >= UINT32_MAX)
+        return false;
+    f.n = static_cast<uint32_t>(n);
+    f.seed = p.size() > NumParameters ? p.back() : 1;
+    return true;
+}
+
+template <typename Emit>
+void ForEachFamilyEdge(const FamilySpec &f, Emit &&emit)
+{
+    const auto &p = f.p;
+    std::mt19937_64 random(f.seed);
+    if (f.family == "path")
+    {
+        for (uint32_t v = 1; v < f.n; ++v)
+        {
+            emit(v - 1, v);
+        }
+    }
+    else if (f.family == "grid")
+    {
+        uint32_t rows = static_cast<uint32_t>(p[0]), cols = static_cast<uint32_t>(p[1]);
+        for (uint32_t r = 0; r < rows; ++r)
+        {
+            for (uint32_t c = 0; c < cols; ++c)
+            {
+                uint32_t v = r * cols + c;
+                if (c + 1 < cols)
+                    emit(v, v + 1);
+                if (r + 1 < rows)
+                    emit(v, v + cols);
+            }
+        }
+    }
+    else if (f.family == "random")
+    {
+        std::uniform_int_distribution<uint32_t> vertex(0, f.n - 1);
+        for (uint64_t i = 0; i < p[1]; ++i)
+        {
+            uint32_t u = vertex(random);
+            emit(u, vertex(random));
+        }
+    }
+    else if (f.family == "rmat")
+    {
+        // quadrant probabilities a = 0.57, b = 0.19, c = 0.19, d = 0.05 as thresholds on 16 random bits
+        const uint32_t A = 37355, AB = 49807, ABC = 62259;
+        for (uint64_t i = 0; i < p[1]; ++i)
+        {
+            uint32_t u = 0, v = 0;
+            uint64_t bits = 0;
+            for (uint64_t level = 0; level < p[0]; ++level)
+            {
+                if (level % 4 == 0)
+                    bits = random();
+                uint32_t r = static_cast<uint32_t>(bits & 0xffff);
+                bits >>= 16;
+                u = (u << 1) | (r >= AB);
+                v = (v << 1) | ((r >= A && r < AB) || r >= ABC);
+            }
+            emit(u, v);
+        }
+    }
+    else // cliques
+    {
+        uint32_t K = static_cast<uint32_t>(p[0]), S = static_cast<uint32_t>(p[1]);
+        // clique 0 is 0 ... S - 1; clique i > 0 is shared[i], a vertex of an earlier clique,
+        // plus the S - 1 new vertices from S + (i - 1) * (S - 1)
+        auto member = [&](uint32_t i, uint32_t k, const std::vector<uint32_t> &shared) {
+            if (i == 0)
+                return k;
+            return k == 0 ? shared[i] : S + (i - 1) * (S - 1) + k - 1;
+        };
+        std::vector<uint32_t> shared(K, 0);
+        for (uint32_t i = 0; i < K; ++i)
+        {
+            if (i > 0)
+            {
+                uint32_t j = std::uniform_int_distribution<uint32_t>(0, i - 1)(random);
+                shared[i] = member(j, std::uniform_int_distribution<uint32_t>(0, S - 1)(random), shared);
+            }
+            for (uint32_t a = 0; a < S; ++a)
+            {
+                for (uint32_t b = a + 1; b < S; ++b)
+                {
+                    emit(member(i, a, shared), member(i, b, shared));
+                }
+            }
+        }
+    }
+}
+
+// Builds the graph named by spec into graph as a simple undirected graph; false if spec names no family.
+bool GenerateFamily(const std::string &spec, Graph &graph)
+{
+    FamilySpec f;
+    if (!ParseFamilySpec(spec, f))
+        return false;
+    GraphBuilder builder(f.n);
+    ForEachFamilyEdge(f, [&builder](uint32_t u, uint32_t v) { builder.AddEdge(u, v); });
+    graph = builder.Build();
+    return true;
+}
+
+#endif
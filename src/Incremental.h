@@ -0,0 +1,567 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include "BlockCutTree.h"
+#include "utils.h"
+
+// Biconnectivity under edge insertions, after Westbrook and Tarjan.
+// The block-cut forest of the last run is kept rooted: every vertex but a root points at the block above it,
+// and every block at its head, the vertex above it. An edge within a tree merges the blocks on the tree path
+// between its endpoints into one. The path is found by walking up from both ends in turn until the walks meet,
+// and a union-find over the blocks turns the merged path into a single step for later walks. An edge between
+// two trees is a new bridge; the smaller tree is re-rooted at its endpoint, relabelled with the tree id of the
+// other and hung below it. Labels rather than a union-find over the vertices keep the trees splittable, which
+// DecrementalBiconnectivity relies on.
+// Every block merge is paid for once, so a batch costs O(k α(n)) amortised for k edges within trees, plus
+// O(log n) amortised per vertex for re-rooting and relabelling. The vertex set is fixed; repeated edges and
+// self-loops are ignored.
+struct IncrementalBiconnectivity
+{
+    uint32_t n = 0;
+    const Graph *base = nullptr; // the analysed graph, which must outlive this structure
+
+    // per vertex
+    std::vector<uint32_t> ParentBlock; // the block above v (any union-find member of it), UINT32_MAX at a root
+    std::vector<uint32_t> BlocksOf;    // the number of blocks containing v; v is an articulation point when >= 2
+    std::vector<uint32_t> TreeId;      // the tree (connected component) of v
+
+    // per tree
+    std::vector<uint32_t> TreeSize;
+    std::vector<uint32_t> FreeTreeIds;
+
+    // per block, valid at union-find roots
+    std::vector<uint32_t> BlockParent; // union-find over the blocks
+    std::vector<uint32_t> Head;
+    std::vector<uint32_t> BlockEdges; // a block of one edge is a bridge
+
+    uint32_t NumArticulationPoints = 0;
+    uint32_t NumBridges = 0;
+    uint32_t NumBlocks = 0;
+
+    // the edges now: those of base without Deleted, plus Inserted. Only DecrementalBiconnectivity deletes edges.
+    std::unordered_set<uint64_t> Deleted;
+    std::unordered_set<uint64_t> Inserted;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> InsertedAdj; // both ways round
+
+    // scratch for the path walks and tree searches
+    std::vector<uint32_t> VertexMark, BlockMark; // Epoch + side of the walk that passed
+    uint32_t Epoch = 0;
+    std::vector<uint32_t> WalkPath[2];
+    std::vector<uint32_t> EvertPath;
+    std::vector<uint32_t> queue;
+
+    // Takes over the result and block-cut tree of graph in O(n + m).
+    void Build(const Graph &graph, const BiconnectivityResult &result, const BlockCutTree &tree)
+    {
+        n = graph.n;
+        base = &graph;
+        NumBlocks = 0;
+        NumBridges = 0;
+        NumArticulationPoints = static_cast<uint32_t>(result.ArticulationPoints.size());
+        BlockParent.clear();
+        Head.clear();
+        BlockEdges.clear();
+        BlockMark.clear();
+        AddBlocks(result);
+
+        ParentBlock.assign(n, UINT32_MAX);
+        BlocksOf.resize(n);
+        TreeId.assign(n, UINT32_MAX);
+        TreeSize.clear();
+        FreeTreeIds.clear();
+        VertexMark.assign(n, 0);
+        Epoch = 0;
+        Deleted.clear();
+        Inserted.clear();
+        InsertedAdj.clear();
+        for (uint32_t v = 0; v < n; ++v)
+        {
+            uint32_t cut = tree.CutIndex[v];
+            BlocksOf[v] = cut != UINT32_MAX ? static_cast<uint32_t>(tree.Adj(tree.NumBlocks + cut).size()) : graph.Degree(v) > 0;
+        }
+
+        std::vector<uint32_t> VertexOffsets, vertices;
+        ListBlockVertices(graph, result, VertexOffsets, vertices);
+        for (uint32_t root = 0; root < n; ++root)
+        {
+            if (TreeId[root] != UINT32_MAX)
+                continue;
+            HangTree(graph, result, tree, VertexOffsets, vertices, 0, nullptr, root);
+            uint32_t id = NewTreeId();
+            TreeSize[id] = static_cast<uint32_t>(queue.size());
+            for (auto v : queue)
+            {
+                TreeId[v] = id;
+            }
+        }
+    }
+
+    bool HasEdge(uint32_t u, uint32_t v) const
+    {
+        auto adj = base->Adj(u); // sorted, as in every undirected graph
+        if (std::binary_search(adj.begin(), adj.end(), v))
+            return Deleted.count(EdgeKey(u, v)) == 0;
+        return Inserted.count(EdgeKey(u, v)) != 0;
+    }
+
+    void InsertEdges(const std::vector<std::pair<uint32_t, uint32_t>> &batch)
+    {
+        for (auto &edge : batch)
+        {
+            InsertEdge(edge.first, edge.second);
+        }
+    }
+
+    void InsertEdge(uint32_t u, uint32_t v)
+    {
+        if (u == v || HasEdge(u, v))
+            return;
+
+        if (TreeId[u] != TreeId[v])
+        {
+            // hang the smaller tree below the other one through the new bridge
+            if (TreeSize[TreeId[u]] < TreeSize[TreeId[v]])
+                std::swap(u, v);
+            uint32_t OldId = TreeId[v];
+            Relabel(v, TreeId[u]);
+            FreeTreeIds.push_back(OldId);
+            Evert(v);
+            uint32_t bridge = NewBlock(1);
+            Head[bridge] = u;
+            ParentBlock[v] = bridge;
+            EnterBlock(u);
+            EnterBlock(v);
+            ++NumBridges;
+            ++NumBlocks;
+        }
+        else
+        {
+            MergePath(u, v);
+        }
+        AddToEdges(u, v);
+    }
+
+    bool IsArticulationPoint(uint32_t v) const { return BlocksOf[v] >= 2; }
+
+    // the block holding edge (u, v), or UINT32_MAX if u and v share none
+    uint32_t EdgeBlock(uint32_t u, uint32_t v)
+    {
+        if (ParentBlock[u] != UINT32_MAX)
+        {
+            uint32_t b = FindBlock(ParentBlock[u]);
+            if (Head[b] == v || (ParentBlock[v] != UINT32_MAX && FindBlock(ParentBlock[v]) == b))
+                return b;
+        }
+        if (ParentBlock[v] != UINT32_MAX)
+        {
+            uint32_t b = FindBlock(ParentBlock[v]);
+            if (Head[b] == u)
+                return b;
+        }
+        return UINT32_MAX;
+    }
+
+    bool IsBridge(uint32_t u, uint32_t v)
+    {
+        if (u == v)
+            return false; // self-loops are dropped, never edges
+        uint32_t b = EdgeBlock(u, v);
+        return b != UINT32_MAX && BlockEdges[b] == 1;
+    }
+
+    // calls f(w) for every current neighbour w of v
+    template <typename F>
+    void ForEachNeighbour(uint32_t v, F &&f) const
+    {
+        for (auto w : base->Adj(v))
+        {
+            if (Deleted.empty() || Deleted.count(EdgeKey(v, w)) == 0)
+                f(w);
+        }
+        auto added = InsertedAdj.find(v);
+        if (added != InsertedAdj.end())
+        {
+            for (auto w : added->second)
+            {
+                f(w);
+            }
+        }
+    }
+
+    // The current articulation points, bridges and components, listed as BuildComponentLists would list them
+    // for the graph as it is now, in O(n + m).
+    void GetResult(BiconnectivityResult &result)
+    {
+        result.ArticulationPoints.clear();
+        for (uint32_t v = 0; v < n; ++v)
+        {
+            if (IsArticulationPoint(v))
+                result.ArticulationPoints.push_back(v);
+        }
+
+        // all edges (u, v) with u < v in increasing order: those left of the graph merged with the inserted ones
+        std::vector<std::pair<uint32_t, uint32_t>> added;
+        for (auto &list : InsertedAdj)
+        {
+            for (auto w : list.second)
+            {
+                if (list.first < w)
+                    added.push_back({list.first, w});
+            }
+        }
+        std::sort(added.begin(), added.end());
+        std::vector<uint32_t> CanonicalId(BlockParent.size(), UINT32_MAX);
+        auto &offsets = result.ComponentOffsets;
+        offsets.assign(1, 0);
+        result.ComponentEdges.clear();
+        result.Bridges.clear();
+        auto next = added.begin();
+        auto list = [&](uint32_t u, uint32_t v) {
+            uint32_t b = EdgeBlock(u, v);
+            if (BlockEdges[b] == 1)
+                result.Bridges.push_back({u, v});
+            if (CanonicalId[b] == UINT32_MAX)
+            {
+                CanonicalId[b] = static_cast<uint32_t>(offsets.size() - 1);
+                offsets.push_back(0);
+            }
+            ++offsets[CanonicalId[b] + 1];
+            result.ComponentEdges.push_back({u, v});
+        };
+        for (uint32_t u = 0; u < n; ++u)
+        {
+            for (auto v : base->Adj(u))
+            {
+                if (v <= u || (!Deleted.empty() && Deleted.count(EdgeKey(u, v)) != 0))
+                    continue;
+                for (; next != added.end() && next->first == u && next->second < v; ++next)
+                {
+                    list(u, next->second);
+                }
+                list(u, v);
+            }
+            for (; next != added.end() && next->first == u; ++next)
+            {
+                list(u, next->second);
+            }
+        }
+        for (size_t c = 1; c < offsets.size(); ++c)
+        {
+            offsets[c] += offsets[c - 1];
+        }
+
+        // group the edges by component, keeping their order within each
+        std::vector<std::pair<uint32_t, uint32_t>> grouped(result.ComponentEdges.size());
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (auto &edge : result.ComponentEdges)
+        {
+            grouped[fill[CanonicalId[EdgeBlock(edge.first, edge.second)]]++] = edge;
+        }
+        result.ComponentEdges.swap(grouped);
+        result.EdgeComponent.clear(); // positions in graph.AdjArray no longer cover every edge
+    }
+
+  protected:
+    static uint64_t EdgeKey(uint32_t u, uint32_t v) { return uint64_t(std::min(u, v)) << 32 | std::max(u, v); }
+
+    void AddToEdges(uint32_t u, uint32_t v)
+    {
+        if (!Deleted.empty() && Deleted.erase(EdgeKey(u, v)) != 0)
+            return; // an edge of the graph back again
+        Inserted.insert(EdgeKey(u, v));
+        InsertedAdj[u].push_back(v);
+        InsertedAdj[v].push_back(u);
+    }
+
+    uint32_t FindBlock(uint32_t b)
+    {
+        while (BlockParent[b] != b)
+        {
+            BlockParent[b] = BlockParent[BlockParent[b]];
+            b = BlockParent[b];
+        }
+        return b;
+    }
+
+    uint32_t NewBlock(uint32_t edges)
+    {
+        uint32_t b = static_cast<uint32_t>(BlockParent.size());
+        BlockParent.push_back(b);
+        Head.push_back(UINT32_MAX);
+        BlockEdges.push_back(edges);
+        BlockMark.push_back(0);
+        return b;
+    }
+
+    // appends the components of result as blocks, counting them and their bridges
+    uint32_t AddBlocks(const BiconnectivityResult &result)
+    {
+        uint32_t first = static_cast<uint32_t>(BlockParent.size());
+        for (uint32_t c = 0; c < result.NumComponents(); ++c)
+        {
+            uint32_t edges = result.ComponentOffsets[c + 1] - result.ComponentOffsets[c];
+            NewBlock(edges);
+            NumBridges += edges == 1;
+        }
+        NumBlocks += result.NumComponents();
+        return first;
+    }
+
+    uint32_t NewTreeId()
+    {
+        if (FreeTreeIds.empty())
+        {
+            TreeSize.push_back(0);
+            return static_cast<uint32_t>(TreeSize.size() - 1);
+        }
+        uint32_t id = FreeTreeIds.back();
+        FreeTreeIds.pop_back();
+        return id;
+    }
+
+    // moves the tree of v, whole, to tree id
+    void Relabel(uint32_t v, uint32_t id)
+    {
+        uint32_t old = TreeId[v];
+        queue.assign(1, v);
+        TreeId[v] = id;
+        for (size_t i = 0; i < queue.size(); ++i)
+        {
+            ForEachNeighbour(queue[i], [&](uint32_t w) {
+                if (TreeId[w] != id)
+                {
+                    TreeId[w] = id;
+                    queue.push_back(w);
+                }
+            });
+        }
+        TreeSize[id] += TreeSize[old];
+        TreeSize[old] = 0;
+    }
+
+    void SetBlocksOf(uint32_t v, uint32_t count)
+    {
+        NumArticulationPoints -= BlocksOf[v] >= 2;
+        BlocksOf[v] = count;
+        NumArticulationPoints += count >= 2;
+    }
+
+    void EnterBlock(uint32_t v) { SetBlocksOf(v, BlocksOf[v] + 1); }
+    void LeaveBlock(uint32_t v) { SetBlocksOf(v, BlocksOf[v] - 1); }
+
+    void NextEpoch()
+    {
+        if (Epoch >= UINT32_MAX - 2)
+        {
+            std::fill(VertexMark.begin(), VertexMark.end(), 0);
+            std::fill(BlockMark.begin(), BlockMark.end(), 0);
+            Epoch = 0;
+        }
+        Epoch += 2;
+    }
+
+    // the distinct vertices of every component of result, CSR style
+    static void ListBlockVertices(const Graph &graph, const BiconnectivityResult &result, std::vector<uint32_t> &offsets,
+                                  std::vector<uint32_t> &vertices)
+    {
+        offsets.assign(result.NumComponents() + 1, 0);
+        vertices.clear();
+        std::vector<uint32_t> SeenIn(graph.n, UINT32_MAX);
+        for (uint32_t b = 0; b < result.NumComponents(); ++b)
+        {
+            for (uint32_t e = result.ComponentOffsets[b]; e < result.ComponentOffsets[b + 1]; ++e)
+            {
+                for (uint32_t v : {result.ComponentEdges[e].first, result.ComponentEdges[e].second})
+                {
+                    if (SeenIn[v] != b)
+                    {
+                        SeenIn[v] = b;
+                        vertices.push_back(v);
+                    }
+                }
+            }
+            offsets[b + 1] = static_cast<uint32_t>(vertices.size());
+        }
+    }
+
+    // Roots the tree of the block-cut forest of graph that holds root at root, hanging each block below the
+    // vertex it is reached from. Component c of result is block FirstBlock + c, vertex x of graph is vertex
+    // global[x] (x itself without global). Leaves the vertices of the tree in queue.
+    void HangTree(const Graph &graph, const BiconnectivityResult &result, const BlockCutTree &tree,
+                  const std::vector<uint32_t> &VertexOffsets, const std::vector<uint32_t> &vertices, uint32_t FirstBlock,
+                  const uint32_t *global, uint32_t root)
+    {
+        queue.assign(1, root);
+        for (size_t i = 0; i < queue.size(); ++i)
+        {
+            uint32_t x = queue[i];
+            auto hang = [&](uint32_t c) {
+                uint32_t b = FirstBlock + c;
+                if (Head[b] != UINT32_MAX)
+                    return;
+                Head[b] = global ? global[x] : x;
+                for (uint32_t j = VertexOffsets[c]; j < VertexOffsets[c + 1]; ++j)
+                {
+                    uint32_t y = vertices[j];
+                    if (y == x)
+                        continue;
+                    ParentBlock[global ? global[y] : y] = b;
+                    queue.push_back(y);
+                }
+            };
+            if (tree.CutIndex[x] != UINT32_MAX)
+            {
+                for (auto c : tree.Adj(tree.NumBlocks + tree.CutIndex[x]))
+                {
+                    hang(c);
+                }
+            }
+            else if (graph.Degree(x) > 0)
+            {
+                hang(result.EdgeComponent[graph.AdjOffsets[x]]);
+            }
+        }
+    }
+
+    // Makes v the root of its tree by reversing the path of blocks and heads from v up to the old root:
+    // each block on it is now headed by the vertex that was below it.
+    void Evert(uint32_t v)
+    {
+        EvertPath.clear();
+        for (uint32_t x = v; ParentBlock[x] != UINT32_MAX; x = Head[EvertPath.back()])
+        {
+            EvertPath.push_back(FindBlock(ParentBlock[x]));
+        }
+        uint32_t below = v;
+        for (auto b : EvertPath)
+        {
+            uint32_t above = Head[b];
+            Head[b] = below;
+            ParentBlock[above] = b;
+            below = above;
+        }
+        ParentBlock[v] = UINT32_MAX;
+    }
+
+    // Walks up from u and v, in the same tree, in turn, each walk marking what it passes, until one reaches a node
+    // the other has marked: their lowest common ancestor, which is returned. Leaves the blocks below it on the side
+    // of u in WalkPath[0] and on the side of v in WalkPath[1], from the bottom up.
+    uint32_t WalkToMeeting(uint32_t u, uint32_t v, bool &MeetAtBlock)
+    {
+        NextEpoch();
+        uint32_t at[2] = {u, v};
+        bool AtBlock[2] = {false, false}, done[2] = {false, false};
+        WalkPath[0].clear();
+        WalkPath[1].clear();
+        VertexMark[u] = Epoch;
+        VertexMark[v] = Epoch + 1;
+
+        uint32_t meet = UINT32_MAX;
+        MeetAtBlock = false;
+        int other = 0;
+        while (meet == UINT32_MAX)
+        {
+            for (int side = 0; side < 2 && meet == UINT32_MAX; ++side)
+            {
+                if (done[side])
+                    continue;
+                other = 1 - side;
+                if (!AtBlock[side])
+                {
+                    if (ParentBlock[at[side]] == UINT32_MAX)
+                    {
+                        done[side] = true; // at the root
+                        continue;
+                    }
+                    uint32_t b = FindBlock(ParentBlock[at[side]]);
+                    if (BlockMark[b] == Epoch + other)
+                    {
+                        meet = b;
+                        MeetAtBlock = true;
+                        continue;
+                    }
+                    BlockMark[b] = Epoch + side;
+                    WalkPath[side].push_back(b);
+                    at[side] = b;
+                    AtBlock[side] = true;
+                }
+                else
+                {
+                    uint32_t h = Head[at[side]];
+                    if (VertexMark[h] == Epoch + other)
+                    {
+                        meet = h;
+                        continue;
+                    }
+                    VertexMark[h] = Epoch + side;
+                    at[side] = h;
+                    AtBlock[side] = false;
+                }
+            }
+        }
+
+        // the other walk may have gone on past the meeting point
+        auto &path = WalkPath[other];
+        if (MeetAtBlock)
+        {
+            while (path.back() != meet)
+            {
+                path.pop_back();
+            }
+            path.pop_back();
+        }
+        else
+        {
+            while (!path.empty() && Head[path.back()] != meet)
+            {
+                path.pop_back();
+            }
+        }
+        return meet;
+    }
+
+    // Merges the blocks on the tree path from u to v into one, for the new edge (u, v).
+    void MergePath(uint32_t u, uint32_t v)
+    {
+        bool MeetAtBlock;
+        uint32_t meet = WalkToMeeting(u, v, MeetAtBlock);
+
+        // every two merged blocks that share a vertex take one block away from it
+        uint32_t top = MeetAtBlock ? meet : UINT32_MAX;
+        uint32_t head = MeetAtBlock ? Head[meet] : meet;
+        uint32_t edges = 1;
+        if (top != UINT32_MAX)
+        {
+            NumBridges -= BlockEdges[top] == 1;
+            edges += BlockEdges[top];
+        }
+        else if (!WalkPath[0].empty() && !WalkPath[1].empty())
+        {
+            LeaveBlock(meet);
+        }
+        for (auto &walk : WalkPath)
+        {
+            for (size_t i = 0; i < walk.size(); ++i)
+            {
+                uint32_t b = walk[i];
+                if (i + 1 < walk.size() || MeetAtBlock)
+                    LeaveBlock(Head[b]);
+                NumBridges -= BlockEdges[b] == 1;
+                edges += BlockEdges[b];
+                if (top == UINT32_MAX)
+                {
+                    top = b;
+                }
+                else
+                {
+                    BlockParent[b] = top;
+                    --NumBlocks;
+                }
+            }
+        }
+        Head[top] = head;
+        BlockEdges[top] = edges;
+    }
+};
+
+#endif
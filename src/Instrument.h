@@ -0,0 +1,219 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "Timer.h"
+
+// Runtime-switchable instrumentation: phase timers, named event counters, the number of heap allocations (in the
+// binaries that include AllocationCounting.h) and, where the kernel allows perf_event_open, hardware counters per
+// phase (of the calling thread only).
+// Everything stays off until EnableInstrumentation, typically from a --stats=<path> option; until then a phase
+// costs one clock read and a counter update one predictable branch. Hot loops count into locals and report once
+// at the end. Phases and counters are recorded from the main thread only; threads that set
+// InstrumentationMuted, as every thread does while it analyses one graph of a batch, record nothing.
+
+enum HardwareCounter
+{
+    HW_CYCLES,
+    HW_INSTRUCTIONS,
+    HW_CACHE_MISSES,
+    HW_BRANCH_MISSES,
+    NUM_HW_COUNTERS
+};
+const char *HW_COUNTER_NAMES[NUM_HW_COUNTERS] = {"cycles", "instructions", "cache_misses", "branch_misses"};
+
+struct PhaseStats
+{
+    std::string name;
+    double ms = 0;
+    uint64_t calls = 0;
+    uint64_t hardware[NUM_HW_COUNTERS] = {};
+};
+
+struct Instrumentation
+{
+    std::atomic<bool> enabled{false};
+    std::atomic<uint64_t> allocations{0};
+    std::vector<PhaseStats> phases; // in order of first use
+    std::vector<std::pair<std::string, uint64_t>> counters;
+    int HardwareFds[NUM_HW_COUNTERS] = {-1, -1, -1, -1};
+    bool HasHardwareCounters = false;
+};
+
+Instrumentation &Stats()
+{
+    static Instrumentation stats;
+    return stats;
+}
+
+inline bool InstrumentationEnabled() { return Stats().enabled.load(std::memory_order_relaxed); }
+
+thread_local bool InstrumentationMuted = false;
+
+// whether phases and counters of the calling thread are recorded
+inline bool Recording() { return InstrumentationEnabled() && !InstrumentationMuted; }
+
+void EnableInstrumentation()
+{
+    auto &stats = Stats();
+    const uint64_t configs[NUM_HW_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                               PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    stats.HasHardwareCounters = true;
+    for (int c = 0; c < NUM_HW_COUNTERS; ++c)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[c];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        stats.HardwareFds[c] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        if (stats.HardwareFds[c] < 0)
+            stats.HasHardwareCounters = false; // not permitted or not supported, e.g. in most containers
+    }
+    stats.enabled = true;
+}
+
+void ReadHardwareCounters(uint64_t values[NUM_HW_COUNTERS])
+{
+    auto &stats = Stats();
+    for (int c = 0; c < NUM_HW_COUNTERS; ++c)
+    {
+        values[c] = 0;
+        if (stats.HasHardwareCounters && read(stats.HardwareFds[c], &values[c], sizeof(values[c])) != sizeof(values[c]))
+            values[c] = 0;
+    }
+}
+
+// adds value to the counter called name
+void CountEvent(const char *name, uint64_t value)
+{
+    if (!Recording())
+        return;
+    for (auto &counter : Stats().counters)
+    {
+        if (counter.first == name)
+        {
+            counter.second += value;
+            return;
+        }
+    }
+    Stats().counters.push_back({name, value});
+}
+
+// raises the counter called name to value, for high-water marks
+void RecordMaximum(const char *name, uint64_t value)
+{
+    if (!Recording())
+        return;
+    for (auto &counter : Stats().counters)
+    {
+        if (counter.first == name)
+        {
+            counter.second = std::max(counter.second, value);
+            return;
+        }
+    }
+    Stats().counters.push_back({name, value});
+}
+
+// Times the enclosing scope as phase name; repeated phases of the same name add up.
+// Next ends the current phase and starts another, for functions that run several phases in a row.
+class ScopedPhase
+{
+  public:
+    explicit ScopedPhase(const char *name) : name(name) { Begin(); }
+    ~ScopedPhase() { End(); }
+
+    ScopedPhase(const ScopedPhase &) = delete;
+    ScopedPhase &operator=(const ScopedPhase &) = delete;
+
+    void Next(const char *next)
+    {
+        End();
+        name = next;
+        Begin();
+    }
+
+  private:
+    const char *name;
+    bool active = false;
+    uint64_t start[NUM_HW_COUNTERS];
+    Timer timer;
+
+    void Begin()
+    {
+        active = Recording();
+        if (active)
+            ReadHardwareCounters(start);
+        timer.Start();
+    }
+
+    void End()
+    {
+        double ms = timer.Stop();
+        if (!active)
+            return;
+        uint64_t end[NUM_HW_COUNTERS];
+        ReadHardwareCounters(end);
+
+        auto &phases = Stats().phases;
+        auto phase = std::find_if(phases.begin(), phases.end(), [this](const PhaseStats &p) { return p.name == name; });
+        if (phase == phases.end())
+        {
+            phases.push_back(PhaseStats());
+            phase = phases.end() - 1;
+            phase->name = name;
+        }
+        phase->ms += ms;
+        ++phase->calls;
+        for (int c = 0; c < NUM_HW_COUNTERS; ++c)
+        {
+            phase->hardware[c] += end[c] - start[c];
+        }
+    }
+};
+
+void WriteInstrumentationJson(const char *path)
+{
+    std::ofstream OutputFile(path);
+    if (!OutputFile.is_open())
+    {
+        std::cout << "Error: could not write " << path << "\n";
+        exit(1);
+    }
+    auto &stats = Stats();
+    OutputFile << "{\n  \"hardware_counters\": " << (stats.HasHardwareCounters ? "true" : "false") << ",\n  \"phases\": [";
+    for (size_t i = 0; i < stats.phases.size(); ++i)
+    {
+        auto &phase = stats.phases[i];
+        OutputFile << (i ? "," : "") << "\n    {\"name\": \"" << phase.name << "\", \"ms\": " << phase.ms << ", \"calls\": " << phase.calls;
+        for (int c = 0; c < NUM_HW_COUNTERS && stats.HasHardwareCounters; ++c)
+        {
+            OutputFile << ", \"" << HW_COUNTER_NAMES[c] << "\": " << phase.hardware[c];
+        }
+        OutputFile << "}";
+    }
+    OutputFile << "\n  ],\n  \"counters\": {";
+    for (size_t i = 0; i < stats.counters.size(); ++i)
+    {
+        OutputFile << (i ? "," : "") << "\n    \"" << stats.counters[i].first << "\": " << stats.counters[i].second;
+    }
+    OutputFile << (stats.counters.empty() ? "" : ",") << "\n    \"allocations\": " << stats.allocations.load() << "\n  }\n}\n";
+}
+
+#endif
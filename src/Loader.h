@@ -0,0 +1,495 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <strings.h>
+
+#include "BinaryGraph.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include "utils.h"
+
+inline bool IsDigit(char c) { return static_cast<unsigned char>(c - '0') < 10; }
+
+// Parses the unsigned decimal integer at p and advances p past it.
+// Returns false (leaving p untouched) if p does not point at a digit or the value overflows uint32_t.
+// Up to 8 digits are converted at once with SWAR arithmetic when 8 bytes are readable.
+bool ParseUInt32(const char *&p, const char *end, uint32_t &value)
+{
+    const char *q = p;
+    uint64_t x = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (end - q >= 8)
+    {
+        uint64_t chunk;
+        memcpy(&chunk, q, 8);
+        uint64_t digits = chunk ^ 0x3030303030303030ULL; // '0'..'9' become 0..9
+        // a byte is a digit iff it is below 10 after the xor; adding 0x76 sets the top bit of every other byte
+        uint64_t NonDigit = ((digits + 0x7676767676767676ULL) | digits) & 0x8080808080808080ULL;
+        int len = NonDigit ? __builtin_ctzll(NonDigit) / 8 : 8;
+        if (len == 0)
+            return false;
+        // move the digits to the top bytes so the missing ones act as leading zeros
+        digits <<= 8 * (8 - len);
+        digits = ((digits & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+        digits = ((digits & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+        x = ((digits & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32;
+        q += len;
+    }
+#endif
+    if (q == p && (q == end || !IsDigit(*q)))
+        return false;
+    while (q < end && IsDigit(*q))
+    {
+        x = x * 10 + static_cast<uint64_t>(*q - '0');
+        if (x > UINT32_MAX)
+            return false;
+        ++q;
+    }
+    if (x > UINT32_MAX)
+        return false;
+    value = static_cast<uint32_t>(x);
+    p = q;
+    return true;
+}
+
+void ReportParseError(const char *path, const char *begin, const char *p)
+{
+    Fail("Error: " + std::string(path) + ": unexpected input at line " + std::to_string(std::count(begin, p, '\n') + 1));
+}
+
+// the loaded graph keeps 32-bit offsets, so it holds fewer than 2^32 neighbour entries
+void ReportTooManyEdges(const char *path)
+{
+    Fail("Error: " + std::string(path) + ": too many edges for 32-bit offsets");
+}
+
+void SkipBlanks(const char *&p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        ++p;
+}
+
+void SkipLine(const char *&p, const char *end)
+{
+    p = static_cast<const char *>(memchr(p, '\n', static_cast<size_t>(end - p)));
+    p = p == nullptr ? end : p + 1;
+}
+
+// Reads the first line of an .in file, which holds n, and leaves p at the start of the second line
+uint32_t ParseAdjacencyHeader(const char *path, const MappedFile &file, const char *&p)
+{
+    const char *end = file.end();
+    uint32_t n = 0;
+    while (p < end && isspace(static_cast<unsigned char>(*p)))
+        ++p;
+    if (!ParseUInt32(p, end, n))
+        ReportParseError(path, file.begin(), p);
+    SkipBlanks(p, end);
+    if (p < end && *p != '\n')
+        ReportParseError(path, file.begin(), p);
+    if (p < end)
+        ++p;
+    return n;
+}
+
+// Appends the neighbours listed on the line at p to neighbours and leaves p at the start of the next line.
+// Returns false, with p at the offending character, on anything but ids below n.
+bool ParseAdjacencyLine(const char *&p, const char *end, uint32_t n, GraphArray<uint32_t> &neighbours)
+{
+    for (;;)
+    {
+        SkipBlanks(p, end);
+        if (p == end || *p == '\n')
+            break;
+        uint32_t w;
+        if (!ParseUInt32(p, end, w) || w >= n)
+            return false;
+        neighbours.push_back(w);
+    }
+    if (p < end)
+        ++p; // the newline
+    return true;
+}
+
+// Loads a graph in the .in adjacency format:
+// the first line holds n, line i + 1 lists the neighbours of vertex i (possibly none).
+// The file is mapped into memory and parsed in place straight into the CSR arrays.
+Graph LoadAdjacencyFile(const char *path)
+{
+    MappedFile file;
+    MapInputFile(file, path);
+    const char *p = file.begin();
+    const char *end = file.end();
+    uint32_t n = ParseAdjacencyHeader(path, file, p);
+
+    Graph graph(n);
+    graph.AdjArray.reserve(static_cast<size_t>(end - p) / 4); // a guess, most ids take several digits
+
+    uint32_t v = 0;
+    while (v < n && p < end)
+    {
+        if (!ParseAdjacencyLine(p, end, n, graph.AdjArray))
+            ReportParseError(path, file.begin(), p);
+        if (graph.AdjArray.size() > UINT32_MAX)
+            ReportTooManyEdges(path);
+        graph.EndVertex();
+        ++v;
+    }
+    for (; v < n; ++v)
+    {
+        graph.EndVertex(); // trailing vertices without a line have no neighbours
+    }
+
+    graph.m = static_cast<uint32_t>(graph.AdjArray.size());
+    return graph;
+}
+
+// Splits [p, end) into at most parts ranges that each start at the beginning of a line.
+// Returns the range boundaries, p first and end last.
+std::vector<const char *> SplitAtLines(const char *p, const char *end, unsigned parts)
+{
+    std::vector<const char *> bounds{p};
+    for (unsigned i = 1; i < parts; ++i)
+    {
+        const char *cut = p + static_cast<size_t>(end - p) * i / parts;
+        if (cut <= bounds.back())
+            continue;
+        SkipLine(--cut, end); // the line boundary at or after the cut
+        if (cut > bounds.back() && cut < end)
+            bounds.push_back(cut);
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+
+// Parallel version of LoadAdjacencyFile.
+// The lines are split into byte ranges that are parsed on the pool, each into its own neighbour and degree
+// arrays. The degrees are then laid out per vertex and turned into the offsets with a parallel prefix sum,
+// and each range copies its neighbours to their final place.
+Graph LoadAdjacencyFileParallel(const char *path, ThreadPool &pool)
+{
+    MappedFile file;
+    MapInputFile(file, path);
+    const char *p = file.begin();
+    const char *end = file.end();
+    uint32_t n = ParseAdjacencyHeader(path, file, p);
+
+    struct Chunk
+    {
+        GraphArray<uint32_t> neighbours;
+        std::vector<uint32_t> degrees; // one per line
+        const char *error = nullptr; // on the line after the last of degrees
+    };
+    auto bounds = SplitAtLines(p, end, pool.Size() * 4);
+    std::vector<Chunk> chunks(bounds.size() - 1);
+    pool.Run(static_cast<uint32_t>(chunks.size()), [&](uint32_t c) {
+        const char *q = bounds[c];
+        auto &chunk = chunks[c];
+        while (q < bounds[c + 1])
+        {
+            size_t before = chunk.neighbours.size();
+            if (!ParseAdjacencyLine(q, bounds[c + 1], n, chunk.neighbours))
+            {
+                chunk.error = q;
+                return;
+            }
+            chunk.degrees.push_back(static_cast<uint32_t>(chunk.neighbours.size() - before));
+        }
+    });
+
+    // the vertex and array position each chunk starts at; lines past vertex n - 1 are ignored, errors on them
+    // too, as LoadAdjacencyFile never reads them
+    std::vector<uint32_t> FirstVertex(chunks.size()), FirstEntry(chunks.size());
+    uint64_t v = 0, entries = 0;
+    for (size_t c = 0; c < chunks.size(); ++c)
+    {
+        if (chunks[c].error != nullptr && v + chunks[c].degrees.size() < n)
+            ReportParseError(path, file.begin(), chunks[c].error);
+        FirstVertex[c] = static_cast<uint32_t>(std::min<uint64_t>(v, n));
+        FirstEntry[c] = static_cast<uint32_t>(entries);
+        for (auto degree : chunks[c].degrees)
+        {
+            if (v++ < n)
+                entries += degree;
+        }
+    }
+    if (entries > UINT32_MAX)
+        ReportTooManyEdges(path);
+
+    std::vector<uint32_t> offsets(n + 1, 0);
+    std::vector<uint32_t> array(entries);
+    pool.Run(static_cast<uint32_t>(chunks.size()), [&](uint32_t c) {
+        auto &chunk = chunks[c];
+        uint32_t count = std::min<uint32_t>(static_cast<uint32_t>(chunk.degrees.size()), n - FirstVertex[c]);
+        std::copy(chunk.degrees.begin(), chunk.degrees.begin() + count, offsets.begin() + FirstVertex[c]);
+        uint64_t copied = c + 1 < chunks.size() ? FirstEntry[c + 1] - FirstEntry[c] : entries - FirstEntry[c];
+        std::copy(chunk.neighbours.begin(), chunk.neighbours.begin() + copied, array.begin() + FirstEntry[c]);
+        chunk = Chunk(); // release as soon as possible
+    });
+    ParallelPrefixSum(pool, offsets.data(), offsets.size());
+
+    Graph graph(n);
+    graph.AdjOffsets.Adopt(std::move(offsets));
+    graph.AdjArray.Adopt(std::move(array));
+    graph.m = static_cast<uint32_t>(entries);
+    return graph;
+}
+
+// Parallel version of GraphBuilder::Build for edges collected in several lists.
+// Degrees are counted and edges scattered with atomic increments, the offsets come from a parallel
+// prefix sum, and the neighbour lists are sorted, deduplicated and compacted in parallel.
+Graph BuildUndirectedParallel(ThreadPool &pool, uint32_t n, std::vector<std::vector<std::pair<uint32_t, uint32_t>>> &EdgeLists)
+{
+    uint32_t lists = static_cast<uint32_t>(EdgeLists.size());
+    std::vector<uint32_t> offsets(n + 1, 0);
+    pool.Run(lists, [&](uint32_t l) {
+        for (auto &e : EdgeLists[l])
+        {
+            if (e.first == e.second)
+                continue;
+            __atomic_fetch_add(&offsets[e.first], 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&offsets[e.second], 1, __ATOMIC_RELAXED);
+        }
+    });
+    uint64_t total = ParallelPrefixSum(pool, offsets.data(), offsets.size());
+    if (total > UINT32_MAX)
+        Fail("Error: too many edges for 32-bit offsets");
+
+    std::vector<uint32_t> array(total);
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    pool.Run(lists, [&](uint32_t l) {
+        for (auto &e : EdgeLists[l])
+        {
+            if (e.first == e.second)
+                continue;
+            array[__atomic_fetch_add(&fill[e.first], 1, __ATOMIC_RELAXED)] = e.second;
+            array[__atomic_fetch_add(&fill[e.second], 1, __ATOMIC_RELAXED)] = e.first;
+        }
+        std::vector<std::pair<uint32_t, uint32_t>>().swap(EdgeLists[l]);
+    });
+
+    // sort and deduplicate each list in place, then compact into a fresh array
+    std::vector<uint32_t> kept(n + 1, 0);
+    ParallelFor(pool, n, [&](uint64_t first, uint64_t last) {
+        for (uint64_t v = first; v < last; ++v)
+        {
+            auto begin = array.begin() + offsets[v], end = array.begin() + offsets[v + 1];
+            std::sort(begin, end);
+            kept[v] = static_cast<uint32_t>(std::unique(begin, end) - begin);
+        }
+    });
+    uint64_t KeptTotal = ParallelPrefixSum(pool, kept.data(), kept.size());
+    std::vector<uint32_t> compact(KeptTotal);
+    ParallelFor(pool, n, [&](uint64_t first, uint64_t last) {
+        for (uint64_t v = first; v < last; ++v)
+        {
+            std::copy(array.begin() + offsets[v], array.begin() + offsets[v] + (kept[v + 1] - kept[v]), compact.begin() + kept[v]);
+        }
+    });
+
+    Graph graph(n);
+    graph.AdjOffsets.Adopt(std::move(kept));
+    graph.AdjArray.Adopt(std::move(compact));
+    graph.m = static_cast<uint32_t>(KeptTotal);
+    graph.IsUndirected = true;
+    return graph;
+}
+
+struct MatrixMarketSize
+{
+    uint32_t rows, cols, nnz;
+};
+
+// Skips the comment and blank lines at p; Matrix Market allows them before the size line
+// and, in practice, they also show up between entries
+void SkipMatrixMarketComments(const char *&p, const char *end)
+{
+    for (;;)
+    {
+        SkipBlanks(p, end);
+        if (p < end && (*p == '%' || *p == '\n'))
+            SkipLine(p, end);
+        else
+            return;
+    }
+}
+
+// Checks the banner, reads the size line and leaves p at the first entry
+MatrixMarketSize ParseMatrixMarketHeader(const char *path, const MappedFile &file, const char *&p)
+{
+    const char *end = file.end();
+
+    // banner: %%MatrixMarket matrix coordinate <field> <symmetry>
+    const char *banner = "%%MatrixMarket";
+    if (static_cast<size_t>(end - p) >= strlen(banner) && !strncasecmp(p, banner, strlen(banner)))
+    {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        std::string header(p, eol == nullptr ? end : eol);
+        std::transform(header.begin(), header.end(), header.begin(), ::tolower);
+        if (header.find(" coordinate") == std::string::npos)
+            Fail("Error: " + std::string(path) + ": only coordinate Matrix Market files are supported");
+    }
+
+    MatrixMarketSize size;
+    SkipMatrixMarketComments(p, end);
+    if (!ParseUInt32(p, end, size.rows))
+        ReportParseError(path, file.begin(), p);
+    SkipBlanks(p, end);
+    if (!ParseUInt32(p, end, size.cols))
+        ReportParseError(path, file.begin(), p);
+    SkipBlanks(p, end);
+    if (!ParseUInt32(p, end, size.nnz))
+        ReportParseError(path, file.begin(), p);
+    SkipLine(p, end);
+    return size;
+}
+
+// Parses the entry at p into the 0-based edge {i, j} and leaves p at the next line.
+// Returns false, with p at the offending character, on a malformed or out of range entry.
+bool ParseMatrixMarketEntry(const char *&p, const char *end, const MatrixMarketSize &size, uint32_t &i, uint32_t &j)
+{
+    if (!ParseUInt32(p, end, i) || i == 0 || i > size.rows)
+        return false;
+    SkipBlanks(p, end);
+    if (!ParseUInt32(p, end, j) || j == 0 || j > size.cols)
+        return false;
+    --i;
+    --j;
+    SkipLine(p, end); // the value, if any
+    return true;
+}
+
+// Loads a Matrix Market coordinate file (https://math.nist.gov/MatrixMarket/formats.html) as an undirected graph.
+// Entry (i, j) becomes the edge {i - 1, j - 1}. Values are ignored, so every field (pattern, real, integer,
+// complex) is accepted, and general and symmetric matrices give the same graph since edges are symmetrised anyway.
+Graph LoadMatrixMarket(const char *path)
+{
+    MappedFile file;
+    MapInputFile(file, path);
+    const char *p = file.begin();
+    const char *end = file.end();
+    auto size = ParseMatrixMarketHeader(path, file, p);
+
+    GraphBuilder builder(std::max(size.rows, size.cols), size.nnz);
+    for (uint32_t k = 0; k < size.nnz; ++k)
+    {
+        SkipMatrixMarketComments(p, end);
+        uint32_t i, j;
+        if (!ParseMatrixMarketEntry(p, end, size, i, j))
+            ReportParseError(path, file.begin(), p);
+        builder.AddEdge(i, j);
+    }
+
+    return builder.Build();
+}
+
+// Parallel version of LoadMatrixMarket: the entries are split into byte ranges parsed on the pool,
+// then handed to BuildUndirectedParallel. Entries past the nnz announced by the size line are ignored.
+Graph LoadMatrixMarketParallel(const char *path, ThreadPool &pool)
+{
+    MappedFile file;
+    MapInputFile(file, path);
+    const char *p = file.begin();
+    const char *end = file.end();
+    auto size = ParseMatrixMarketHeader(path, file, p);
+
+    auto bounds = SplitAtLines(p, end, pool.Size() * 4);
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> EdgeLists(bounds.size() - 1);
+    std::vector<const char *> errors(bounds.size() - 1, nullptr);
+    pool.Run(static_cast<uint32_t>(EdgeLists.size()), [&](uint32_t c) {
+        const char *q = bounds[c];
+        EdgeLists[c].reserve(static_cast<size_t>(bounds[c + 1] - q) / 8);
+        for (;;)
+        {
+            SkipMatrixMarketComments(q, bounds[c + 1]);
+            if (q == bounds[c + 1])
+                return;
+            uint32_t i, j;
+            if (!ParseMatrixMarketEntry(q, bounds[c + 1], size, i, j))
+            {
+                errors[c] = q;
+                return;
+            }
+            EdgeLists[c].push_back({i, j});
+        }
+    });
+
+    uint64_t entries = 0;
+    for (size_t c = 0; c < EdgeLists.size(); ++c)
+    {
+        if (entries >= size.nnz)
+        {
+            EdgeLists[c].clear();
+            continue;
+        }
+        if (errors[c] != nullptr)
+            ReportParseError(path, file.begin(), errors[c]);
+        if (entries + EdgeLists[c].size() > size.nnz)
+            EdgeLists[c].resize(size.nnz - entries);
+        entries += EdgeLists[c].size();
+    }
+    if (entries < size.nnz)
+        ReportParseError(path, file.begin(), end);
+
+    return BuildUndirectedParallel(pool, std::max(size.rows, size.cols), EdgeLists);
+}
+
+// Loads a .bcsr binary graph, a .mtx Matrix Market file or a file in the .in adjacency format.
+// Text files are parsed on NumThreads threads.
+Graph LoadGraph(const char *path, unsigned NumThreads = 1)
+{
+    ScopedPhase phase("load");
+    if (EndsWith(path, ".bcsr"))
+        return LoadBinaryGraph(path);
+    if (NumThreads > 1)
+    {
+        ThreadPool pool(NumThreads);
+        if (EndsWith(path, ".mtx"))
+            return LoadMatrixMarketParallel(path, pool);
+        return LoadAdjacencyFileParallel(path, pool);
+    }
+    if (EndsWith(path, ".mtx"))
+        return LoadMatrixMarket(path);
+    return LoadAdjacencyFile(path);
+}
+
+// convert input.{in,mtx} output.bcsr [--degree-order] [--id-bytes=2|4|8] [--threads=N]
+// Writes the graph of input, made undirected, as a binary graph; --degree-order also stores the degree permutation.
+// The vertex ids are as narrow as the graph allows, or --id-bytes wide if that is wider.
+int ConvertMain(int argc, char *argv[], const char *program)
+{
+    bool WithPermutation = false;
+    uint32_t IdBytes = 0;
+    unsigned NumThreads = std::thread::hardware_concurrency();
+    std::vector<char *> paths;
+    for (int i = 2; i < argc; ++i)
+    {
+        const char *value;
+        if (!strcmp(argv[i], "--degree-order"))
+            WithPermutation = true;
+        else if (MatchOption(argv[i], "--threads", value) && ParseThreadCount(value) != 0)
+            NumThreads = ParseThreadCount(value);
+        else if (MatchOption(argv[i], "--id-bytes", value) && (!strcmp(value, "2") || !strcmp(value, "4") || !strcmp(value, "8")))
+            IdBytes = static_cast<uint32_t>(atoi(value));
+        else
+            paths.push_back(argv[i]);
+    }
+    if (paths.size() != 2 || !EndsWith(paths[1], ".bcsr"))
+    {
+        cout << "Usage: " << program << " convert file_path.in|file_path.mtx output.bcsr [--degree-order] [--id-bytes=2|4|8] [--threads=N]\n";
+        return 1;
+    }
+
+    Graph graph = LoadGraph(paths[0], NumThreads);
+    MakeUndirected(graph);
+    IdBytes = std::max(IdBytes, VertexIdBytesFor(graph.n));
+    if (!WriteBinaryGraph(graph, paths[1], WithPermutation, IdBytes))
+    {
+        cout << "Could not write " << paths[1] << "\n";
+        return 1;
+    }
+    cout << "Wrote " << paths[1] << ": " << graph.n << " vertices, " << graph.m / 2 << " edges, " << IdBytes << "-byte ids\n";
+    return 0;
+}
+
+#endif
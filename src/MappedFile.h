@@ -0,0 +1,121 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils.h"
+
+// A read-only memory mapping of a whole file
+struct MappedFile
+{
+    const char *data = nullptr;
+    size_t size = 0;
+
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile() { Close(); }
+
+    bool Open(const char *path)
+    {
+        Close();
+        fd = open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            Close();
+            return false;
+        }
+        size = static_cast<size_t>(st.st_size);
+        if (size == 0)
+            return true; // mmap refuses empty mappings, an empty file is just an empty range
+        void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            Close();
+            return false;
+        }
+        madvise(addr, size, MADV_SEQUENTIAL);
+        data = static_cast<const char *>(addr);
+        return true;
+    }
+
+    void Close()
+    {
+        if (data != nullptr)
+            munmap(const_cast<char *>(data), size);
+        if (fd >= 0)
+            close(fd);
+        data = nullptr;
+        size = 0;
+        fd = -1;
+    }
+
+    const char *begin() const { return data; }
+    const char *end() const { return data + size; }
+
+  private:
+    int fd = -1;
+};
+
+// A shared read-write mapping of a file created with a fixed size, for output that is written out of order.
+// Closing it leaves the contents in the file.
+struct WritableMappedFile
+{
+    char *data = nullptr;
+    size_t size = 0;
+
+    WritableMappedFile() = default;
+    WritableMappedFile(const WritableMappedFile &) = delete;
+    WritableMappedFile &operator=(const WritableMappedFile &) = delete;
+    ~WritableMappedFile() { Close(); }
+
+    // creates or truncates path to size zero bytes and maps it
+    bool Create(const char *path, size_t bytes)
+    {
+        Close();
+        fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            return false;
+        size = bytes;
+        if (size == 0)
+            return true;
+        void *addr = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+            addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            Close();
+            return false;
+        }
+        data = static_cast<char *>(addr);
+        return true;
+    }
+
+    void Close()
+    {
+        if (data != nullptr)
+            munmap(data, size);
+        if (fd >= 0)
+            close(fd);
+        data = nullptr;
+        size = 0;
+        fd = -1;
+    }
+
+  private:
+    int fd = -1;
+};
+
+void MapInputFile(MappedFile &file, const char *path)
+{
+    if (!file.Open(path))
+        Fail("Could not open " + std::string(path));
+}
+
+#endif
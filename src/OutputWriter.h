@@ -0,0 +1,205 @@
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include "BinaryGraph.h"
+#include "utils.h"
+
+// Buffered output of results. Numbers are formatted by hand into a large buffer that reaches the stream in
+// blocks of a megabyte, so listing millions of ears costs little more than copying their digits.
+class OutputWriter
+{
+  public:
+    explicit OutputWriter(std::ostream &stream = std::cout, size_t capacity = 1 << 20) : stream(stream), buffer(capacity) {}
+    ~OutputWriter() { Flush(); }
+
+    OutputWriter(const OutputWriter &) = delete;
+    OutputWriter &operator=(const OutputWriter &) = delete;
+
+    OutputWriter &operator<<(char c)
+    {
+        Reserve(1);
+        buffer[used++] = c;
+        return *this;
+    }
+
+    OutputWriter &operator<<(const char *str)
+    {
+        size_t len = strlen(str);
+        if (len > buffer.size())
+        {
+            Flush();
+            stream.write(str, static_cast<std::streamsize>(len));
+            return *this;
+        }
+        Reserve(len);
+        memcpy(buffer.data() + used, str, len);
+        used += len;
+        return *this;
+    }
+
+    OutputWriter &operator<<(uint16_t value) { return *this << uint64_t(value); }
+    OutputWriter &operator<<(uint32_t value) { return *this << uint64_t(value); }
+
+    OutputWriter &operator<<(uint64_t value)
+    {
+        Reserve(20);
+        char digits[20];
+        int count = 0;
+        do
+        {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        while (count > 0)
+        {
+            buffer[used++] = digits[--count];
+        }
+        return *this;
+    }
+
+    void Flush()
+    {
+        if (used != 0)
+            stream.write(buffer.data(), static_cast<std::streamsize>(used));
+        used = 0;
+    }
+
+  private:
+    std::ostream &stream;
+    std::vector<char> buffer;
+    size_t used = 0;
+
+    void Reserve(size_t bytes)
+    {
+        if (used + bytes > buffer.size())
+            Flush();
+    }
+};
+
+// How much of a result the programs print, each level adding to the one before:
+//   summary  the numbers of articulation points, bridges and biconnected components
+//   cut      the articulation points
+//   bridges  the bridges as well
+//   full     everything: the components, and for schmidt its chains (ears) and the block-cut tree
+enum Verbosity
+{
+    VERBOSITY_SUMMARY,
+    VERBOSITY_CUT,
+    VERBOSITY_BRIDGES,
+    VERBOSITY_FULL
+};
+
+// false if value names no verbosity
+bool ParseVerbosity(const char *value, Verbosity &verbosity)
+{
+    const char *names[] = {"summary", "cut", "bridges", "full"};
+    for (int level = VERBOSITY_SUMMARY; level <= VERBOSITY_FULL; ++level)
+    {
+        if (!strcmp(value, names[level]))
+        {
+            verbosity = static_cast<Verbosity>(level);
+            return true;
+        }
+    }
+    return false;
+}
+
+// the summary line, or the articulation points and, from VERBOSITY_BRIDGES on, the bridges
+template <typename VertexId>
+void PrintCutsAndBridges(OutputWriter &out, const std::vector<VertexId> &ArticulationPoints,
+                         const std::vector<std::pair<VertexId, VertexId>> &Bridges, uint64_t NumComponents, Verbosity verbosity)
+{
+    if (verbosity == VERBOSITY_SUMMARY)
+    {
+        out << "Summary: " << uint64_t(ArticulationPoints.size()) << " articulation points, "
+            << uint64_t(Bridges.size()) << " bridges, " << NumComponents << " biconnected components\n";
+        return;
+    }
+    out << "Articulation points: ";
+    for (auto v : ArticulationPoints)
+    {
+        out << v << ' ';
+    }
+    out << '\n';
+    if (verbosity < VERBOSITY_BRIDGES)
+        return;
+    out << "Bridges: ";
+    for (auto &bridge : Bridges)
+    {
+        out << bridge.first << '-' << bridge.second << ',';
+    }
+    out << '\n';
+}
+
+template <typename VertexId, typename EdgeId>
+void PrintBiconnectivity(OutputWriter &out, const BasicBiconnectivityResult<VertexId, EdgeId> &result, Verbosity verbosity = VERBOSITY_FULL)
+{
+    PrintCutsAndBridges(out, result.ArticulationPoints, result.Bridges, result.NumComponents(), verbosity);
+    if (verbosity < VERBOSITY_FULL)
+        return;
+    out << "Biconnected components: " << result.NumComponents() << '\n';
+    for (VertexId c = 0; c < result.NumComponents(); ++c)
+    {
+        out << "Component " << c << ':';
+        for (EdgeId e = result.ComponentOffsets[c]; e < result.ComponentOffsets[c + 1]; ++e)
+        {
+            out << ' ' << result.ComponentEdges[e].first << '-' << result.ComponentEdges[e].second;
+        }
+        out << '\n';
+    }
+}
+
+// Binary result file (--binary-output), in the byte order of the machine that wrote it:
+//
+//   BinaryResultHeader
+//   uint32_t ArticulationPoints[NumArticulationPoints]
+//   uint32_t Bridges[2 * NumBridges]                    (u, v) pairs
+//   uint32_t ComponentOffsets[NumComponents + 1]
+//   uint32_t ComponentEdges[2 * NumComponentEdges]      (u, v) pairs
+//
+// with the same contents and order as BiconnectivityResult.
+const char BINARY_RESULT_MAGIC[8] = {'B', 'C', 'C', 'R', 'E', 'S', 'L', 'T'};
+const uint32_t BINARY_RESULT_VERSION = 1;
+
+struct BinaryResultHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t ByteOrderMark; // = BINARY_GRAPH_BYTE_ORDER_MARK, as in a binary graph
+    uint64_t n;
+    uint64_t NumArticulationPoints;
+    uint64_t NumBridges;
+    uint64_t NumComponents;
+    uint64_t NumComponentEdges;
+};
+
+void WriteBinaryResult(const char *path, uint32_t n, const BiconnectivityResult &result)
+{
+    std::ofstream OutputFile(path, std::ios::binary | std::ios::trunc);
+    BinaryResultHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_RESULT_MAGIC, sizeof(header.magic));
+    header.version = BINARY_RESULT_VERSION;
+    header.ByteOrderMark = BINARY_GRAPH_BYTE_ORDER_MARK;
+    header.n = n;
+    header.NumArticulationPoints = result.ArticulationPoints.size();
+    header.NumBridges = result.Bridges.size();
+    header.NumComponents = result.NumComponents();
+    header.NumComponentEdges = result.ComponentEdges.size();
+
+    auto write = [&OutputFile](const void *data, size_t bytes) {
+        OutputFile.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+    };
+    write(&header, sizeof(header));
+    write(result.ArticulationPoints.data(), result.ArticulationPoints.size() * sizeof(uint32_t));
+    write(result.Bridges.data(), result.Bridges.size() * 2 * sizeof(uint32_t)); // pairs of uint32_t are packed
+    write(result.ComponentOffsets.data(), result.ComponentOffsets.size() * sizeof(uint32_t));
+    write(result.ComponentEdges.data(), result.ComponentEdges.size() * 2 * sizeof(uint32_t));
+    if (!OutputFile.good())
+    {
+        cout << "Error: could not write " << path << "\n";
+        exit(1);
+    }
+}
+
+#endif
@@ -0,0 +1,269 @@
+#ifndef QUERY_SERVER_H
+#define QUERY_SERVER_H
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "DynamicBiconnectivity.h"
+#include "Loader.h"
+#include "OutputWriter.h"
+#include "TarjanHopcroft.h"
+#include "utils.h"
+
+// Query server: loads a graph once, analyses it, keeps its block-cut tree (see DynamicBiconnectivity.h) and
+// answers queries read from stdin or from the clients of a local Unix socket, one by one. One query per line,
+// one answer line per query:
+//   cut v            yes if v is an articulation point
+//   bridge u v       yes if (u, v) is an edge and a bridge
+//   same u v         yes if u and v lie in a common biconnected component
+//   separators u w   the articulation points separating u from w, in order from u; "none", or "disconnected"
+//   + u v / - u v    inserts or deletes the edge (u, v): ok
+//   stats            the numbers of vertices, articulation points, bridges and biconnected components
+//   quit             ends the session: the input, or the connection of a socket client
+//   shutdown         stops the server
+// Malformed queries get an answer starting with "error:". Answers are buffered and written out whenever the
+// queries received so far have all been answered, so batches of queries cost one write.
+
+// a stream buffer writing to a file descriptor, for answering over a socket
+struct DescriptorBuffer : std::streambuf
+{
+    int fd;
+    bool failed = false;
+
+    explicit DescriptorBuffer(int fd) : fd(fd) {}
+
+    std::streamsize xsputn(const char *data, std::streamsize count) override
+    {
+        std::streamsize done = 0;
+        while (done < count && !failed)
+        {
+            ssize_t written = send(fd, data + done, static_cast<size_t>(count - done), MSG_NOSIGNAL);
+            if (written <= 0)
+                failed = true; // the client went away; its remaining answers are dropped
+            else
+                done += written;
+        }
+        return count;
+    }
+
+    int overflow(int c) override
+    {
+        char ch = static_cast<char>(c);
+        xsputn(&ch, 1);
+        return c;
+    }
+};
+
+// reads the next vertex id of a query into v; false if there is none or it is out of range
+bool ParseQueryVertex(const char *&p, uint32_t n, uint32_t &v)
+{
+    while (*p == ' ' || *p == '\t')
+        ++p;
+    if (*p < '0' || *p > '9')
+        return false;
+    uint64_t value = 0;
+    while (*p >= '0' && *p <= '9' && value < n)
+        value = value * 10 + static_cast<uint64_t>(*p++ - '0');
+    if (value >= n || (*p >= '0' && *p <= '9'))
+        return false;
+    v = static_cast<uint32_t>(value);
+    return true;
+}
+
+enum QueryOutcome
+{
+    QUERY_ANSWERED,
+    QUERY_QUIT,
+    QUERY_SHUTDOWN
+};
+
+QueryOutcome AnswerQuery(DynamicBiconnectivity &dynamic, const char *line, OutputWriter &out, std::vector<uint32_t> &cuts)
+{
+    const char *p = line;
+    while (*p == ' ' || *p == '\t')
+        ++p;
+    const char *word = p;
+    while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '\r')
+        ++p;
+    std::string command(word, p);
+    uint32_t u = 0, v = 0;
+    auto vertices = [&](int count) {
+        bool ok = ParseQueryVertex(p, dynamic.n, u) && (count == 1 || ParseQueryVertex(p, dynamic.n, v));
+        while (*p == ' ' || *p == '\t' || *p == '\r')
+            ++p;
+        if (!ok || *p != '\0')
+        {
+            out << "error: " << command.c_str() << " expects " << (count == 1 ? "a vertex" : "two vertices") << " below " << dynamic.n << '\n';
+            return false;
+        }
+        return true;
+    };
+
+    if (command.empty())
+    {
+        return QUERY_ANSWERED;
+    }
+    else if (command == "cut")
+    {
+        if (vertices(1))
+            out << (dynamic.IsArticulationPoint(u) ? "yes\n" : "no\n");
+    }
+    else if (command == "bridge")
+    {
+        if (vertices(2))
+            out << (dynamic.IsBridge(u, v) ? "yes\n" : "no\n");
+    }
+    else if (command == "same")
+    {
+        if (vertices(2))
+            out << (dynamic.InSameBlock(u, v) ? "yes\n" : "no\n");
+    }
+    else if (command == "separators")
+    {
+        if (!vertices(2))
+            return QUERY_ANSWERED;
+        if (!dynamic.Separators(u, v, cuts))
+        {
+            out << "disconnected\n";
+        }
+        else if (cuts.empty())
+        {
+            out << "none\n";
+        }
+        else
+        {
+            for (size_t i = 0; i < cuts.size(); ++i)
+            {
+                out << (i ? " " : "") << cuts[i];
+            }
+            out << '\n';
+        }
+    }
+    else if (command == "+" || command == "-")
+    {
+        if (!vertices(2))
+            return QUERY_ANSWERED;
+        if (command == "+")
+            dynamic.InsertEdge(u, v);
+        else
+            dynamic.DeleteEdge(u, v);
+        out << "ok\n";
+    }
+    else if (command == "stats")
+    {
+        out << dynamic.n << " vertices, " << dynamic.NumArticulationPoints << " articulation points, " << dynamic.NumBridges
+            << " bridges, " << dynamic.NumBlocks << " biconnected components\n";
+    }
+    else if (command == "quit" || command == "shutdown")
+    {
+        return command == "quit" ? QUERY_QUIT : QUERY_SHUTDOWN;
+    }
+    else
+    {
+        out << "error: unknown query " << command.c_str() << '\n';
+    }
+    return QUERY_ANSWERED;
+}
+
+// Answers the queries arriving on fd until the end of the input, quit or shutdown; false after shutdown.
+bool ServeQueries(DynamicBiconnectivity &dynamic, int fd, std::ostream &answers)
+{
+    OutputWriter out(answers);
+    std::vector<uint32_t> cuts;
+    std::vector<char> buffer(1 << 16);
+    std::string line;
+    for (;;)
+    {
+        ssize_t got = read(fd, buffer.data(), buffer.size());
+        if (got <= 0)
+            return line.empty() || AnswerQuery(dynamic, line.c_str(), out, cuts) != QUERY_SHUTDOWN; // a last line without '\n'
+        for (ssize_t i = 0; i < got; ++i)
+        {
+            if (buffer[i] != '\n')
+            {
+                line.push_back(buffer[i]);
+                continue;
+            }
+            QueryOutcome outcome = AnswerQuery(dynamic, line.c_str(), out, cuts);
+            if (outcome != QUERY_ANSWERED)
+                return outcome == QUERY_QUIT;
+            line.clear();
+        }
+        out.Flush();
+        answers.flush();
+    }
+}
+
+int ServeMain(int argc, char *argv[], const char *program)
+{
+    unsigned NumThreads = std::thread::hardware_concurrency();
+    const char *SocketPath = nullptr;
+    std::vector<char *> paths;
+    for (int i = 2; i < argc; ++i)
+    {
+        const char *value;
+        if (MatchOption(argv[i], "--socket", value))
+            SocketPath = value;
+        else if (MatchOption(argv[i], "--threads", value) && ParseThreadCount(value) != 0)
+            NumThreads = ParseThreadCount(value);
+        else
+            paths.push_back(argv[i]);
+    }
+    if (paths.size() != 1 || (SocketPath != nullptr && strlen(SocketPath) >= sizeof(sockaddr_un().sun_path)))
+    {
+        cout << "Usage: " << program << " serve file_path.in|file_path.mtx|file_path.bcsr [--socket=path] [--threads=N]\n";
+        return 1;
+    }
+
+    Graph graph = LoadGraph(paths[0], NumThreads);
+    MakeUndirected(graph);
+    BiconnectivityResult result;
+    TarjanHopcroft(graph, result);
+    BlockCutTree tree;
+    BuildBlockCutTree(graph, result, tree);
+    DynamicBiconnectivity dynamic;
+    dynamic.Build(graph, result, tree);
+    result = BiconnectivityResult();
+    tree = BlockCutTree();
+
+    if (SocketPath == nullptr)
+    {
+        ServeQueries(dynamic, STDIN_FILENO, cout);
+        return 0;
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, SocketPath);
+    struct stat existing;
+    if (stat(SocketPath, &existing) == 0 && S_ISSOCK(existing.st_mode))
+        unlink(SocketPath); // left over from an earlier server
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listener, 16) != 0)
+    {
+        cout << "Error: could not listen on " << SocketPath << "\n";
+        return 1;
+    }
+    cout << "Serving " << paths[0] << " on " << SocketPath << "\n" << std::flush;
+
+    // one client at a time: queries may update the graph, and they are answered in the order they arrive
+    bool running = true;
+    while (running)
+    {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0)
+            continue;
+        DescriptorBuffer buffer(client);
+        std::ostream answers(&buffer);
+        running = ServeQueries(dynamic, client, answers);
+        close(client);
+    }
+    close(listener);
+    unlink(SocketPath);
+    return 0;
+}
+
+#endif
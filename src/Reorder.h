@@ -0,0 +1,205 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "BinaryGraph.h"
+#include "utils.h"
+
+// Vertex reordering: relabels the vertices of an undirected graph so that the vertices a traversal reaches one
+// after another, and their neighbour lists, lie close together in memory, runs the analysis on the relabelled
+// graph and maps its result back to the original ids. Worth it when the input ids scatter the neighbours of
+// a vertex over the whole graph, as in crawled web and social graphs.
+enum VertexOrder
+{
+    ORDER_NONE,
+    ORDER_BFS,    // breadth-first order, roots and neighbours by id
+    ORDER_RCM,    // reverse Cuthill-McKee: breadth-first from low-degree roots, neighbours by increasing degree, reversed
+    ORDER_DEGREE, // by decreasing degree (the permutation stored by convert --degree-order, if there is one)
+    ORDER_DFS     // depth-first preorder, roots and neighbours by id
+};
+
+bool ParseVertexOrder(const char *value, VertexOrder &order)
+{
+    static const char *const NAMES[] = {"none", "bfs", "rcm", "degree", "dfs"};
+    for (int i = 0; i <= ORDER_DFS; ++i)
+    {
+        if (!strcmp(value, NAMES[i]))
+        {
+            order = static_cast<VertexOrder>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// how the vertices and edges of a relabelled graph correspond to those of the original one
+struct VertexRelabelling
+{
+    std::vector<uint32_t> Order;          // Order[x] = the original id of vertex x
+    std::vector<uint32_t> SourcePosition; // entry p of the relabelled AdjArray is the original entry
+                                          // SourcePosition[p] read the other way round
+};
+
+// appends the vertices of the component of root to order in breadth-first order; with ByDegree, the
+// neighbours of each vertex are taken by increasing degree
+void BreadthFirstOrder(const Graph &graph, uint32_t root, bool ByDegree, std::vector<char> &seen, std::vector<uint32_t> &order)
+{
+    size_t head = order.size();
+    seen[root] = 1;
+    order.push_back(root);
+    while (head < order.size())
+    {
+        uint32_t v = order[head++];
+        size_t first = order.size();
+        for (auto w : graph.Adj(v))
+        {
+            if (!seen[w])
+            {
+                seen[w] = 1;
+                order.push_back(w);
+            }
+        }
+        if (ByDegree)
+        {
+            std::sort(order.begin() + static_cast<std::ptrdiff_t>(first), order.end(), [&graph](uint32_t a, uint32_t b) {
+                return graph.Degree(a) != graph.Degree(b) ? graph.Degree(a) < graph.Degree(b) : a < b;
+            });
+        }
+    }
+}
+
+// appends the vertices of the component of root to order in depth-first preorder
+void DepthFirstOrder(const Graph &graph, uint32_t root, std::vector<char> &seen, std::vector<uint32_t> &order)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> s; // (vertex, next neighbour index)
+    seen[root] = 1;
+    order.push_back(root);
+    s.push_back({root, 0});
+    while (!s.empty())
+    {
+        uint32_t v = s.back().first;
+        uint32_t &next = s.back().second;
+        auto adj = graph.Adj(v);
+        while (next < adj.size() && seen[adj[next]])
+            ++next;
+        if (next == adj.size())
+        {
+            s.pop_back();
+            continue;
+        }
+        uint32_t w = adj[next++];
+        seen[w] = 1;
+        order.push_back(w);
+        s.push_back({w, 0});
+    }
+}
+
+// The new order of the vertices of graph: order[x] is the original id of the vertex that becomes x. O(n + m),
+// plus sorting every neighbour list by degree for ORDER_RCM and n log n for ORDER_DEGREE without a stored permutation.
+std::vector<uint32_t> ComputeVertexOrder(const Graph &graph, VertexOrder kind)
+{
+    std::vector<uint32_t> order;
+    if (kind == ORDER_DEGREE)
+    {
+        if (graph.DegreePermutation.size() == graph.n)
+            order.assign(graph.DegreePermutation.begin(), graph.DegreePermutation.end());
+        else
+            order = DegreeOrder(graph);
+        return order;
+    }
+
+    order.reserve(graph.n);
+    std::vector<char> seen(graph.n, 0);
+    std::vector<uint32_t> roots(graph.n);
+    for (uint32_t v = 0; v < graph.n; ++v)
+    {
+        roots[v] = v;
+    }
+    if (kind == ORDER_RCM)
+    {
+        // a peripheral vertex makes a narrow breadth-first layering; the lowest-degree vertex of each
+        // component is the usual cheap stand-in for one
+        std::stable_sort(roots.begin(), roots.end(), [&graph](uint32_t a, uint32_t b) { return graph.Degree(a) < graph.Degree(b); });
+    }
+    for (auto root : roots)
+    {
+        if (seen[root])
+            continue;
+        if (kind == ORDER_DFS)
+            DepthFirstOrder(graph, root, seen, order);
+        else
+            BreadthFirstOrder(graph, root, kind == ORDER_RCM, seen, order);
+    }
+    if (kind == ORDER_RCM)
+        std::reverse(order.begin(), order.end());
+    return order;
+}
+
+// Relabels the vertices of an undirected graph in the given order and returns the relabelled graph, with its
+// neighbour lists sorted. Placing every vertex into the lists of its neighbours in increasing order of its new
+// id sorts the lists without comparing anything, so this is O(n + m).
+Graph RelabelGraph(const Graph &graph, VertexOrder kind, VertexRelabelling &relabelling)
+{
+    ScopedPhase phase("reorder");
+    relabelling.Order = ComputeVertexOrder(graph, kind);
+    auto &order = relabelling.Order;
+    std::vector<uint32_t> NewId(graph.n);
+    for (uint32_t x = 0; x < graph.n; ++x)
+    {
+        NewId[order[x]] = x;
+    }
+
+    phase.Next("relabel");
+    std::vector<uint32_t> offsets(graph.n + 1, 0);
+    for (uint32_t x = 0; x < graph.n; ++x)
+    {
+        offsets[x + 1] = offsets[x] + graph.Degree(order[x]);
+    }
+    std::vector<uint32_t> array(graph.AdjArray.size());
+    relabelling.SourcePosition.resize(graph.AdjArray.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (uint32_t x = 0; x < graph.n; ++x)
+    {
+        uint32_t v = order[x];
+        for (uint32_t i = graph.AdjOffsets[v]; i < graph.AdjOffsets[v + 1]; ++i)
+        {
+            uint32_t p = fill[NewId[graph.AdjArray[i]]]++;
+            array[p] = x;
+            relabelling.SourcePosition[p] = i;
+        }
+    }
+
+    Graph relabelled(graph.n);
+    relabelled.AdjOffsets.Adopt(std::move(offsets));
+    relabelled.AdjArray.Adopt(std::move(array));
+    relabelled.m = static_cast<uint32_t>(relabelled.AdjArray.size());
+    relabelled.IsUndirected = true;
+    return relabelled;
+}
+
+// Turns result, found on the relabelled graph, into the result for the original graph: the same articulation
+// points, bridges and components under the original ids, listed in the canonical order again. O(n + m) apart
+// from sorting the articulation points and bridges.
+void MapResultBack(const Graph &graph, const VertexRelabelling &relabelling, BiconnectivityResult &result)
+{
+    ScopedPhase phase("map back");
+    auto &order = relabelling.Order;
+    for (auto &v : result.ArticulationPoints)
+    {
+        v = order[v];
+    }
+    std::sort(result.ArticulationPoints.begin(), result.ArticulationPoints.end());
+    for (auto &bridge : result.Bridges)
+    {
+        bridge = std::minmax(order[bridge.first], order[bridge.second]);
+    }
+    std::sort(result.Bridges.begin(), result.Bridges.end());
+
+    std::vector<uint32_t> label(graph.AdjArray.size());
+    for (size_t p = 0; p < label.size(); ++p)
+    {
+        label[relabelling.SourcePosition[p]] = result.EdgeComponent[p];
+    }
+    ListComponents(graph, [&label](uint32_t, uint32_t, uint32_t i) { return label[i]; }, result);
+}
+
+#endif
@@ -1,3 +1,10 @@
+#include "AllocationCounting.h"
+#include "Arena.h"
+#include "Batch.h"
+#include "BlockCutTree.h"
+#include "ChainDecomposition.h"
+#include "Loader.h"
+#include "OutputWriter.h"
 #include "utils.h"
 #include "Timer.h"
 using std::cerr;
@@ -5,322 +12,343 @@ using std::cin;
 using std::cout;
 
 
-void CheckArgs(int argc, char *argv[])
+struct Options
 {
-    if (argc != 2)
+    char *InputPath = nullptr;
+    std::string Engine = "chain"; // chain | legacy
+    const char *StatsPath = nullptr; // --stats=<path>: write instrumentation as JSON
+    Verbosity Output = VERBOSITY_FULL; // --output=summary|cut|bridges|full
+    const char *BinaryOutputPath = nullptr; // --binary-output=<path>: also write the result as a binary file
+    unsigned NumThreads = std::thread::hardware_concurrency(); // for loading text input
+};
+
+void CheckArgs(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *value;
+        if (MatchOption(argv[i], "--engine", value))
+        {
+            options.Engine = value;
+        }
+        else if (MatchOption(argv[i], "--stats", value))
+        {
+            options.StatsPath = value;
+        }
+        else if (MatchOption(argv[i], "--output", value))
+        {
+            if (!ParseVerbosity(value, options.Output))
+            {
+                cout << "--output expects summary, cut, bridges or full\n";
+                exit(1);
+            }
+        }
+        else if (MatchOption(argv[i], "--binary-output", value))
+        {
+            options.BinaryOutputPath = value;
+        }
+        else if (MatchOption(argv[i], "--threads", value))
+        {
+            options.NumThreads = ParseThreadCount(value);
+            if (options.NumThreads == 0)
+            {
+                cout << "--threads expects a positive number\n";
+                exit(1);
+            }
+        }
+        else if (argv[i][0] == '-' || options.InputPath != nullptr)
+        {
+            options.InputPath = nullptr;
+            break;
+        }
+        else
+        {
+            options.InputPath = argv[i];
+        }
+    }
+
+    if (options.InputPath == nullptr)
     {
-        cout << "Usage: ./tarjan file_path.in\n";
+        cout << "Usage: ./schmidt [--engine=chain|legacy] [--threads=N] [--output=summary|cut|bridges|full]\n"
+                "                [--binary-output=result.bin] [--stats=stats.json] file_path.in|file_path.mtx|file_path.bcsr\n";
+        cout << "       ./schmidt convert file_path.in|file_path.mtx output.bcsr [--degree-order] [--id-bytes=2|4|8] [--threads=N]\n";
+        cout << "       ./schmidt batch manifest.txt|directory [--output=summary|cut|bridges|full] [--threads=N] [--stats=stats.json]\n";
         exit(1);
     }
-    else if (!(strlen(argv[1]) >= 3 && !strcmp(argv[1] + strlen(argv[1]) - 3, ".in")))
+    else if (!EndsWith(options.InputPath, ".in") && !EndsWith(options.InputPath, ".mtx") && !EndsWith(options.InputPath, ".bcsr"))
     {
-        cout << "The file must end in .in\n";
+        cout << "The file must end in .in, .mtx or .bcsr\n";
+        exit(1);
+    }
+    else if (options.Engine != "chain" && options.Engine != "legacy")
+    {
+        cout << "Unknown engine " << options.Engine << "\n";
+        exit(1);
+    }
+    else if (options.Engine == "legacy" && options.BinaryOutputPath != nullptr)
+    {
+        cout << "The legacy engine has no components to write with --binary-output\n";
         exit(1);
     }
 }
 
-void MakeDFSGraphWithBackEdges(Graph &graph)
+// the back edges of every tree go to arena
+void MakeDFSGraphWithBackEdges(Graph &graph, Arena &arena)
 {
-    std::unordered_set<uint32_t> unvisited; // unvisited nodes
-    unvisited.reserve(graph.n);
-    for (uint32_t i = 0; i < graph.n; ++i)
-    {
-        unvisited.insert(i);
-    }
+    ScopedPhase phase("dfs");
+    uint64_t VerticesVisited = 0, EdgesScanned = 0;
+    size_t StackHighWater = 0;
+    auto &state = graph.State;
+    state.Reset(graph.n);
+    VertexFlags visited(graph.n);
+    std::stack<std::pair<uint32_t, uint32_t>, std::vector<std::pair<uint32_t, uint32_t>>> s; // stack<pair<cur, prev>> to get the DFS trees
 
-    while (!unvisited.empty())
+    // every tree is rooted at the lowest vertex not visited yet, so the forest depends on the input alone
+    for (uint32_t root = visited.NextClear(0); root < graph.n; root = visited.NextClear(root + 1))
     {
-        auto root = unvisited.begin();
-        graph.DFSForest.push_back(Tree(*root)); // create a new tree
+        graph.DFSForest.push_back(Tree(root, arena)); // create a new tree
         auto &curTree = graph.DFSForest.back();
+        uint32_t CurTreeNum = static_cast<uint32_t>(graph.DFSForest.size() - 1);
         uint32_t DiscoveryTime = 1;
-        // find curTree, a DFS tree rooted at *root
-        std::stack<std::pair<uint32_t, uint32_t>> s; // stack<pair<cur, prev>> to get the DFS tree
-        s.push({*root, UINT32_MAX});
+        // find curTree, a DFS tree rooted at root
+        s.push({root, UINT32_MAX});
         while (!s.empty())
         {
             uint32_t v = s.top().first;
             uint32_t prev = s.top().second;
+            StackHighWater = std::max(StackHighWater, s.size());
             s.pop();
-            if (unvisited.find(v) != unvisited.end())
+            if (visited.TestAndSet(v))
             {
-                unvisited.erase(v); // mark v as visited
-                if (prev == UINT32_MAX)
-                {
-                    // v is the root
-                    curTree.AdjMap.insert({v, Tree::PointProperties(DiscoveryTime)});
-
-                    ++DiscoveryTime;
-
-                    graph.TreeNum.at(v) = static_cast<uint32_t>(graph.DFSForest.size() - 1);
-                }
-                else
+                ++VerticesVisited;
+                state.DiscoveryTime[v] = DiscoveryTime;
+                ++DiscoveryTime;
+                state.TreeNum[v] = CurTreeNum;
+                ++curTree.NumVertices;
+                if (prev != UINT32_MAX)
                 {
                     // v is not the root
-                    if (curTree.AdjMap.count(prev) == 0)
-                    {
-                        cerr << "Error: prev not present in the map!\n";
-                        exit(1);
-                    }
-                    try
-                    {
-                        curTree.AdjMap.at(prev).neighbours.push_back(v);
-                    }
-                    catch (const std::out_of_range &e)
-                    {
-                        std::cerr << "Error: Prev (" << prev << ") not present in the map: " << e.what() << "\n";
-                        exit(1);
-                    }
-                    if (curTree.AdjMap.count(v) == 0)
-                    {
-                        curTree.AdjMap.insert({v, Tree::PointProperties(DiscoveryTime)});
-                        ++DiscoveryTime;
-
-                        graph.TreeNum.at(v) = static_cast<uint32_t>(graph.DFSForest.size() - 1);
-                    }
-                    try
-                    {
-                        curTree.AdjMap.at(v).parent = prev;
-                    }
-                    catch (const std::out_of_range &e)
-                    {
-                        std::cerr << "Error: V (" << v << ") not present in the map: " << e.what() << "\n";
-                        exit(1);
-                    }
+                    state.AddChild(prev, v);
                 }
 
-                for (uint32_t i = 0; i < graph.AdjList.at(v).size(); ++i)
+                for (auto w : graph.Adj(v))
                 {
-                    if (unvisited.find(graph.AdjList[v][i]) != unvisited.end())
-                        s.push({graph.AdjList[v][i], v}); // push w for all edges vw
+                    ++EdgesScanned;
+                    if (!visited[w])
+                        s.push({w, v}); // push w for all edges vw
                 }
             }
             else
             {
-                try
-                {
-                    // curTree.AdjMap.at(prev).parent = v;
-                    curTree.BackEdge.push_back(Tree::DiscoveredBackEdge(prev, v, curTree.AdjMap.at(prev).DiscoveryTime, curTree.AdjMap.at(v).DiscoveryTime));
-                }
-                catch (const std::out_of_range &e)
-                {
-                    std::cerr << "Error: V (" << v << ") not present in the map: " << e.what() << "\n";
-                    exit(1);
-                }
+                curTree.BackEdge.push_back(Tree::DiscoveredBackEdge(prev, v, state.DiscoveryTime[prev], state.DiscoveryTime[v]));
             }
         }
     }
+    CountEvent("vertices visited", VerticesVisited);
+    CountEvent("edges scanned", EdgesScanned);
+    RecordMaximum("stack high-water", StackHighWater);
 }
 
-void LoadGraph(std::ifstream &InputFile, Graph &graph)
+// the back edges of tree in order of the discovery time of their upper end, by counting sort; count is scratch
+void SortBackEdges(Tree &tree, std::vector<uint32_t> &count)
 {
-    SkipNLines(InputFile, 1, std::ios::beg);
-    std::string line;
-    line.reserve(graph.n * 2);
-
-    uint32_t i = 0;
-    while (std::getline(InputFile, line))
+    count.assign(tree.NumVertices + 2, 0);
+    for (auto &e : tree.BackEdge)
     {
-        std::stringstream stream(line);
-        uint32_t j = 0;
-        while (stream >> j)
-        {
-            graph.AdjList.at(i).push_back(j);
-            ++graph.m;
-        }
-        ++i;
+        ++count[e.DiscoveryTime1];
+    }
+    uint32_t sum = 0;
+    for (auto &c : count)
+    {
+        uint32_t next = sum + c;
+        c = sum;
+        sum = next;
+    }
+    ArenaVector<Tree::DiscoveredBackEdge> unsorted(tree.BackEdge); // in the same arena
+    for (auto &e : unsorted)
+    {
+        tree.BackEdge[count[e.DiscoveryTime1]++] = e;
     }
-
-    assert(graph.AdjList.size() == graph.n);
 }
 
-struct atrcuate_bridge
-{
-    std::unordered_set<uint32_t> atriculate;
-    std::vector<std::vector<uint32_t>> bridge;
-};
-atrcuate_bridge CheckBiconnectivity(std::vector<Tree> &Forest, const Graph &graph)
+// Schmidt's chain decomposition over the DFS forest above. The back edges of every tree are taken by the
+// discovery time of their upper end (vertex1); each ear is the back edge followed by the tree path up from its
+// lower end (vertex2) to the first vertex an earlier ear reached. Then, in a simple undirected graph:
+//  - the bridges are the tree edges no ear covers;
+//  - a vertex is an articulation point if it starts an ear that is a cycle, other than the first ear of its
+//    tree, or if it ends a bridge and has another edge;
+//  - there is one biconnected component per bridge and one per cycle ear.
+// Prints the ears and a verdict on every tree at VERBOSITY_FULL only; the ears are stored in arena.
+void CheckBiconnectivity(std::vector<Tree> &Forest, const Graph &graph, OutputWriter &out, Verbosity verbosity, Arena &arena)
 {
-    cout << "--------------------EARS___________________________";
-    std::vector<std::vector<uint32_t>> EarRemovedAdjList = graph.AdjList;
-    std::unordered_set<uint32_t> articulatep(graph.n);
-    std::unordered_set<uint32_t> visited;
+    const auto &state = graph.State;
+    bool PrintEars = verbosity == VERBOSITY_FULL;
+    if (PrintEars)
+        out << "--------------------EARS___________________________\n";
+    // the ears, stored back to back like Chains: ear e is EarVertices[EarStart[e] ... EarStart[e + 1] - 1]
+    ArenaVector<uint32_t> EarStart(1, 0, ArenaAllocator<uint32_t>(arena));
+    ArenaVector<uint32_t> EarVertices{ArenaAllocator<uint32_t>(arena)};
+    std::vector<uint32_t> TreeVertices, count;
+    std::vector<std::pair<uint32_t, uint32_t>> bridges;
+    VertexFlags articulatep(graph.n);
+    VertexFlags visited(graph.n);
+    VertexFlags InEar(graph.n); // the tree edge from v to its parent lies on an ear
+    uint64_t CycleEars = 0;
     for (uint32_t i = 0; i < Forest.size(); ++i)
     {
-        uint32_t keep_count = Forest[i].AdjMap.size();
-
-        // sorted by discovery time
-        std::sort(Forest[i].BackEdge.begin(), Forest[i].BackEdge.end());
-        std::vector<std::vector<uint32_t>> ears;
-        uint32_t ear_num = 0;
+        {
+            ScopedPhase phase("sort back edges");
+            SortBackEdges(Forest[i], count);
+        }
+        ScopedPhase phase("ear walk");
+        uint32_t cuts = 0; // articulation points found in this tree
         for (uint32_t j = 0; j < Forest[i].BackEdge.size(); ++j)
         {
-            std::vector<uint32_t> ear{Forest[i].BackEdge[j].vertex1};
-            cout << "\nEar" << ear_num << ":";
-            cout << Forest[i].BackEdge[j].vertex1 << "-" << Forest[i].BackEdge[j].vertex2;
-            ear_num += 1;
-            if (ear_num == 1)
-            {
-                cout << "\nEar" << ear_num << ":";
-                cout << Forest[i].BackEdge[j].vertex2;
-            }
-
-            visited.insert(Forest[i].BackEdge[j].vertex1);
-            keep_count--;
-            ear.push_back(Forest[i].BackEdge[j].vertex2);
             uint32_t v1 = Forest[i].BackEdge[j].vertex1;
             uint32_t v2 = Forest[i].BackEdge[j].vertex2;
-            EarRemovedAdjList[v1].erase(std::remove(EarRemovedAdjList[v1].begin(), EarRemovedAdjList[v1].end(), v2), EarRemovedAdjList[v1].end());
-            EarRemovedAdjList[v2].erase(std::remove(EarRemovedAdjList[v2].begin(), EarRemovedAdjList[v2].end(), v1), EarRemovedAdjList[v2].end());
-            while (visited.find(ear.back()) == visited.end())
+            visited.Set(v1);
+            EarVertices.push_back(v1);
+            EarVertices.push_back(v2);
+            while (visited.TestAndSet(EarVertices.back()))
             {
-                visited.insert(ear.back());
-                keep_count--;
-                EarRemovedAdjList[ear.back()].erase(std::remove(EarRemovedAdjList[ear.back()].begin(), EarRemovedAdjList[ear.back()].end(), Forest[i].AdjMap.at(ear.back()).parent), EarRemovedAdjList[ear.back()].end());
-                uint32_t par = Forest[i].AdjMap.at(ear.back()).parent;
-                // cout << "[" << par << ear.back() << "]";
-                if (par < graph.n)
-                    EarRemovedAdjList[par].erase(std::remove(EarRemovedAdjList[par].begin(), EarRemovedAdjList[par].end(), ear.back()), EarRemovedAdjList[par].end());
-                ear.push_back(Forest[i].AdjMap.at(ear.back()).parent);
-
-                cout << "-" << ear.back();
+                uint32_t v = EarVertices.back();
+                InEar.Set(v);
+                EarVertices.push_back(state.Parent[v]);
             }
 
-            if (j != 0 && ear.front() == ear.back())
+            if (EarVertices[EarStart.back()] == EarVertices.back())
             {
-                articulatep.insert(ear.front());
+                ++CycleEars;
+                if (j != 0 && articulatep.TestAndSet(v1))
+                    ++cuts;
             }
-            ears.push_back(ear);
-        }
-        if (keep_count > 0 && keep_count < graph.n) // if unvisited node in the connected Tree
-        {
-            cout << "\nConnected component " << i << " whose DFS Root is " << Forest[i].root << " don't have biconnectivity ";
-        }
-        else
-        {
-            cout << "\nConnected component " << i << " whose DFS Root is " << Forest[i].root << " is biconnected!";
-        }
-
-        for (auto i : Forest[i].AdjMap)
-        {
-            for (uint32_t r = 0; r < i.second.neighbours.size(); r++)
+            if (PrintEars)
             {
-                if (visited.find(i.second.neighbours[r]) == visited.end() && i.second.neighbours.size() != 1)
+                out << "Ear" << j << ':' << EarVertices[EarStart.back()];
+                for (uint32_t k = EarStart.back() + 1; k < EarVertices.size(); ++k)
                 {
-                    articulatep.insert(i.first);
+                    out << '-' << EarVertices[k];
                 }
+                out << '\n';
             }
+            EarStart.push_back(static_cast<uint32_t>(EarVertices.size()));
         }
-    }
-    // my logic not sure....need to verify
-    for (uint32_t x = 0; x < graph.n; ++x)
-    {
-        for (uint32_t r = 0; r < graph.AdjList[x].size(); ++r)
+
+        LevelOrderTraversal(Forest[i], state, TreeVertices);
+        for (auto v : TreeVertices)
         {
-            if (visited.find(graph.AdjList[x][r]) == visited.end() && graph.AdjList[x].size() != 1)
+            uint32_t p = state.Parent[v];
+            if (p == UINT32_MAX || InEar[v])
+                continue;
+            bridges.push_back({std::min(p, v), std::max(p, v)});
+            for (auto x : {p, v})
             {
-                articulatep.insert(x);
+                if (graph.Degree(x) > 1 && articulatep.TestAndSet(x))
+                    ++cuts;
             }
         }
+        if (PrintEars && Forest[i].NumVertices > 1 && cuts == 0)
+            out << "Connected component " << i << " whose DFS Root is " << Forest[i].root << " is biconnected!\n";
+        else if (PrintEars)
+            out << "Connected component " << i << " whose DFS Root is " << Forest[i].root << " don't have biconnectivity\n";
     }
 
-    cout << "\n Articulate points: ";
-    for (auto i = articulatep.begin(); i != articulatep.end(); ++i)
+    std::sort(bridges.begin(), bridges.end());
+    std::vector<uint32_t> points;
+    articulatep.ForEach([&points](uint32_t v) { points.push_back(v); });
+    PrintCutsAndBridges(out, points, bridges, bridges.size() + CycleEars, std::min(verbosity, VERBOSITY_BRIDGES));
+}
+
+// the chains and the block-cut tree at VERBOSITY_FULL only
+void PrintChainDecomposition(OutputWriter &out, const Chains &chains, const BiconnectivityResult &result, const BlockCutTree &tree,
+                             Verbosity verbosity)
+{
+    if (verbosity < VERBOSITY_FULL)
     {
-        std::cout << (*i) << " ";
+        PrintBiconnectivity(out, result, verbosity);
+        return;
     }
-    cout << "\n Bridges: ";
-    for (uint32_t x = 0; x < graph.n; ++x)
+    for (uint32_t c = 0; c < chains.NumChains(); ++c)
     {
-        for (uint32_t r = 0; r < EarRemovedAdjList[x].size(); ++r)
+        out << "Chain " << c << ": " << chains.ChainVertices[chains.ChainStart[c]];
+        for (uint32_t i = chains.ChainStart[c] + 1; i < chains.ChainStart[c + 1]; ++i)
         {
-            if (x < EarRemovedAdjList[x][r])
-                cout << x << "-" << EarRemovedAdjList[x][r] << ",";
+            out << '-' << chains.ChainVertices[i];
         }
+        out << '\n';
     }
-    return atrcuate_bridge{articulatep, EarRemovedAdjList};
-}
-
-void DFS(uint32_t v,uint32_t par,uint32_t b_num,std::unordered_set<uint32_t> &unvisited,std::unordered_set<uint32_t>articulatePoint, std::vector<std::vector< std::pair <uint32_t,uint32_t> >> &biconn,std::vector<std::vector<uint32_t>> Biconnected)
-{
-    // Mark the current node as visited and
-    // print it
-    if(par < Biconnected.size())
-        biconn[b_num].push_back(std::make_pair(v,par));
-    // Recur for all the vertices adjacent
-    // to this vertex
-    
-    for (auto i = Biconnected[v].begin(); i != Biconnected[v].end(); ++i){
-        if (unvisited.find(*i)!=unvisited.end() && articulatePoint.find(*i) == articulatePoint.end() )
-            DFS(*i,v,b_num,unvisited,articulatePoint,biconn,Biconnected);
-        else{
-            biconn[b_num].push_back(std::make_pair(*i,par));
-        }
-    }        
-}
-void findBiconnectedComponent(Graph &graph)
-{
-    atrcuate_bridge s = CheckBiconnectivity(graph.DFSForest, graph);
-    std::vector<std::vector<uint32_t>> Biconnected = graph.AdjList;
-
-    //remove bridges from original graph
-    for (uint32_t x = 0; x < graph.n; ++x)
+    PrintBiconnectivity(out, result);
+    out << "Block-cut tree:\n";
+    for (uint32_t i = 0; i < tree.CutVertices.size(); ++i)
     {
-        for (uint32_t r = 0; r < s.bridge[x].size(); ++r)
+        out << "Cut vertex " << tree.CutVertices[i] << ": components";
+        for (auto block : tree.Adj(tree.NumBlocks + i))
         {
-            if (x < s.bridge[x][r])
-            {
-                s.bridge[x].erase(std::remove(s.bridge[x].begin(), s.bridge[x].end(), s.bridge[x][r]), s.bridge[x].end());
-                s.bridge[ s.bridge[x][r]].erase(std::remove(s.bridge[ s.bridge[x][r]].begin(), s.bridge[ s.bridge[x][r]].end(),x), s.bridge[s.bridge[x][r]].end());
-            }
+            out << ' ' << block;
         }
+        out << '\n';
     }
-    std::unordered_set<uint32_t> unvisited; // unvisited nodes
-    std::vector<std::vector< std::pair <uint32_t,uint32_t> >> biconn;
-    unvisited.reserve(graph.n);
-    biconn.reserve(graph.n);
-    uint32_t b_num=0;
-    for (uint32_t i = 0; i < graph.n; ++i)
-    {
-        unvisited.insert(i);
-    }
-
-     while (!unvisited.empty())
-    {   
-        auto root = unvisited.begin();
-        if(s.atriculate.find(*root) == s.atriculate.end()){
-            DFS(*root,graph.n,b_num,unvisited,s.atriculate, biconn,Biconnected);
-        }
-        b_num++;
-
-    }   
-    //find biconnected component
-
-
+}
 
+// one graph of a batch, with the chain engine
+void AnalyseInBatch(Graph &graph, BiconnectivityResult &result, OutputWriter &out, Verbosity verbosity)
+{
+    Chains chains;
+    BlockCutTree tree;
+    ChainDecomposition(graph, chains, result);
+    if (verbosity == VERBOSITY_FULL)
+        BuildBlockCutTree(graph, result, tree);
+    PrintChainDecomposition(out, chains, result, tree, verbosity);
 }
+
 int main(int argc, char *argv[])
 {
-    CheckArgs(argc, argv);
+    if (argc >= 2 && !strcmp(argv[1], "convert"))
+        return ConvertMain(argc, argv, "./schmidt");
+    if (argc >= 2 && !strcmp(argv[1], "batch"))
+        return BatchMain(argc, argv, "./schmidt", AnalyseInBatch);
 
-    std::ifstream InputFile;
-    OpenInputFile(InputFile, argv[1]);
+    std::ios::sync_with_stdio(false);
+    Options options;
+    CheckArgs(argc, argv, options);
+    if (options.StatsPath != nullptr)
+        EnableInstrumentation();
 
-    uint32_t n;                // number of vertices
-    InputFile >> n >> std::ws; // skip the whitespace at the end of the line before switching to line-based reading using getline
     Timer t;
 
-    Graph graph(n);
-    LoadGraph(InputFile, graph);
+    Arena arena; // the back edges and ears of the legacy engine, released in one go with the graph
+    Graph graph = LoadGraph(options.InputPath, options.NumThreads);
     // PrintGraph(graph);
 
-    MakeDFSGraphWithBackEdges(graph);
-    CheckBiconnectivity(graph.DFSForest, graph);
-    //findBiconnectedComponent(graph);
+    MakeUndirected(graph);
+    if (options.Engine == "legacy")
+    {
+        MakeDFSGraphWithBackEdges(graph, arena);
+        OutputWriter out;
+        CheckBiconnectivity(graph.DFSForest, graph, out, options.Output, arena);
+    }
+    else
+    {
+        Chains chains;
+        BiconnectivityResult result;
+        BlockCutTree tree;
+        ChainDecomposition(graph, chains, result);
+        if (options.Output == VERBOSITY_FULL)
+            BuildBlockCutTree(graph, result, tree);
+        ScopedPhase phase("print");
+        {
+            OutputWriter out;
+            PrintChainDecomposition(out, chains, result, tree, options.Output);
+        }
+        if (options.BinaryOutputPath != nullptr)
+            WriteBinaryResult(options.BinaryOutputPath, graph.n, result);
+    }
     // PrintForest(graph.DFSForest, graph);
 
-    InputFile.close();
+    // on stderr, so that it never runs into the result, which the writers above have flushed by now
     auto duration = t.Stop();
-    cout<<"TimeTaken"<<duration;
+    cerr << "TimeTaken " << duration << " ms\n";
+    if (options.StatsPath != nullptr)
+        WriteInstrumentationJson(options.StatsPath);
     return 0;
 }
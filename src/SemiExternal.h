@@ -0,0 +1,383 @@
+#ifndef SEMI_EXTERNAL_H
+#define SEMI_EXTERNAL_H
+
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <random>
+
+#include "BinaryGraph.h"
+#include "MappedFile.h"
+#include "OutputWriter.h"
+#include "TarjanVishkin.h"
+#include "utils.h"
+
+// Semi-external biconnectivity, for graphs with more edges than fit in memory: the algorithm of TarjanVishkin,
+// run sequentially with O(n) vertex state in memory while the edges stay in a binary graph file and are read
+// from its mapping in sequential passes.
+//  pass 1  a union-find over the edges: an edge that joins two trees is an edge of the spanning forest, which
+//          is then rooted at the smallest vertex of each tree, numbered breadth-first, and given subtree sizes
+//          and preorder numbers in memory
+//  pass 2  low / high over the non-tree edges, then up the forest
+//  pass 3  the non-tree edges of the auxiliary graph (its other rule needs no edges)
+// and with --output=full, for an undirected file (as written by convert, and checked in pass 1):
+//  pass 4  the canonical numbers and sizes of the components (see ListComponents)
+//  pass 5  every edge written to its place in an unlinked scratch file, which is then printed
+// Each window of the neighbour array is dropped from memory as soon as a pass is done with it, so the resident
+// set is the vertex arrays and one window, however large the file. The results equal those of TarjanHopcroft.
+
+// Sequential passes over the edges of a binary graph file.
+class EdgeStream
+{
+  public:
+    static constexpr uint64_t WINDOW_BYTES = uint64_t(64) << 20;
+
+    uint32_t n = 0;
+    bool IsUndirected = false; // every edge is stored both ways, without repeats or self-loops
+    uint32_t passes = 0;
+    uint64_t EdgesStreamed = 0;
+
+    explicit EdgeStream(const char *path) : path(path)
+    {
+        MapInputFile(file, path);
+        if (file.size < sizeof(header))
+            ReportBadBinaryGraph(path, "truncated header");
+        memcpy(&header, file.data, sizeof(header));
+        CheckBinaryGraphHeader(path, header);
+        if (header.n >= UINT32_MAX)
+            ReportBadBinaryGraph(path, "too many vertices for the 32-bit vertex state of the semi-external engine");
+        CheckBinaryGraphLayout(path, header, file.data, file.size);
+        n = static_cast<uint32_t>(header.n);
+        IsUndirected = (header.flags & BINARY_GRAPH_UNDIRECTED) != 0;
+    }
+
+    // Calls fn(u, w) for every edge {u, w} of the file but self-loops. An undirected file gives each edge once,
+    // with u < w, in increasing order; any other file gives every stored entry. The first pass checks, as it goes,
+    // that an undirected file is what its flag claims (see Scan).
+    template <typename Fn>
+    void ForEachEdge(Fn fn)
+    {
+        bool wide = header.OffsetBytes() == 8;
+        if (header.VertexIdBytes == 2)
+            wide ? Scan<uint16_t, uint64_t>(fn) : Scan<uint16_t, uint32_t>(fn);
+        else if (header.VertexIdBytes == 4)
+            wide ? Scan<uint32_t, uint64_t>(fn) : Scan<uint32_t, uint32_t>(fn);
+        else
+            wide ? Scan<uint64_t, uint64_t>(fn) : Scan<uint64_t, uint32_t>(fn);
+        ++passes;
+        EdgesStreamed += header.m;
+    }
+
+  private:
+    const char *path;
+    MappedFile file;
+    BinaryGraphHeader header;
+
+    // mixes the edge {u, w}, u < w, with seed into a hash word
+    static uint64_t EdgeHash(uint64_t seed, uint64_t u, uint64_t w)
+    {
+        uint64_t x = seed ^ (u << 32 | w);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return x ^ (x >> 31);
+    }
+
+    // In the first pass over an undirected file, checks that every neighbour list is strictly increasing and free of
+    // self-loops, and that the lists are symmetric: the edges stored as (u, w) with u < w, which are the only ones
+    // given to fn, must be the edges stored as (w, u). They come in different orders, so rather than matching them
+    // the pass sums a hash of each side, keyed with a random seed; two different sets collide with probability
+    // about 2^-64 whatever the file. A wrong flag would otherwise drop edges without a word.
+    template <typename Id, typename Offset, typename Fn>
+    void Scan(Fn &fn)
+    {
+        auto offsets = reinterpret_cast<const Offset *>(file.data + header.OffsetsPos);
+        auto neighbours = reinterpret_cast<const Id *>(file.data + header.NeighboursPos);
+        bool verify = IsUndirected && passes == 0;
+        uint64_t seed = verify ? (uint64_t(std::random_device()()) << 32 | std::random_device()()) : 0;
+        uint64_t sums[2] = {0, 0}; // of the hashes of the entries with u < w and with u > w
+        uint64_t done = 0;         // the entries of the neighbour array before this one are dropped
+        for (uint32_t u = 0; u < n; ++u)
+        {
+            if (offsets[u + 1] < offsets[u])
+                ReportBadBinaryGraph(path, "decreasing offsets");
+            for (uint64_t i = offsets[u]; i < offsets[u + 1]; ++i)
+            {
+                uint64_t w = neighbours[i];
+                if (w >= n)
+                    ReportBadBinaryGraph(path, "neighbour out of range");
+                if (verify)
+                {
+                    if (w == u)
+                        ReportBadBinaryGraph(path, "self-loop in an undirected graph");
+                    if (i > offsets[u] && w <= neighbours[i - 1])
+                        ReportBadBinaryGraph(path, "unsorted or repeated neighbours in an undirected graph");
+                    sums[u > w] += u < w ? EdgeHash(seed, u, w) : EdgeHash(seed, w, u);
+                }
+                if (w != u && (!IsUndirected || u < w))
+                    fn(u, static_cast<uint32_t>(w));
+            }
+            if ((offsets[u + 1] - done) * sizeof(Id) >= WINDOW_BYTES)
+            {
+                Drop(header.NeighboursPos + done * sizeof(Id), header.NeighboursPos + offsets[u + 1] * sizeof(Id));
+                done = offsets[u + 1];
+            }
+        }
+        Drop(header.NeighboursPos + done * sizeof(Id), header.NeighboursPos + header.m * sizeof(Id));
+        if (verify && sums[0] != sums[1])
+            ReportBadBinaryGraph(path, "asymmetric neighbour lists in an undirected graph");
+    }
+
+    // lets the kernel take back the pages wholly within bytes [first, last) of the file; touching them reads them again
+    void Drop(uint64_t first, uint64_t last)
+    {
+        uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        first = (first + page - 1) / page * page;
+        last = last / page * page;
+        if (first < last)
+            madvise(const_cast<char *>(file.data) + first, last - first, MADV_DONTNEED);
+    }
+};
+
+// maps bytes of scratch space on disk: an unlinked file in $TMPDIR (or /tmp), gone once it is closed
+void CreateScratchFile(WritableMappedFile &file, uint64_t bytes)
+{
+    const char *dir = getenv("TMPDIR");
+    std::string path = std::string(dir != nullptr && *dir != '\0' ? dir : "/tmp") + "/tarjan-scratch-XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd >= 0)
+        close(fd);
+    if (fd < 0 || !file.Create(path.c_str(), bytes))
+    {
+        cout << "Error: could not create a scratch file of " << bytes << " bytes in " << path.substr(0, path.rfind('/')) << "\n";
+        exit(1);
+    }
+    unlink(path.c_str()); // the mapping keeps the space until it is closed
+}
+
+// Analyses the binary graph at path without loading its edges and prints the result at the given verbosity.
+void SemiExternalBiconnectivity(const char *path, OutputWriter &out, Verbosity verbosity)
+{
+    ScopedPhase phase("semi-external forest");
+    EdgeStream edges(path);
+    const uint32_t n = edges.n;
+    if (verbosity == VERBOSITY_FULL && !edges.IsUndirected)
+    {
+        cout << "Error: " << path << ": listing the components semi-externally needs an undirected binary graph "
+                "(./tarjan convert); --output=summary, cut and bridges work on any\n";
+        exit(1);
+    }
+
+    // 1. the spanning forest, as adjacency lists
+    std::vector<uint32_t> ForestStart(n + 1, 0), forest;
+    {
+        ConcurrentUnionFind trees(n);
+        std::vector<std::pair<uint32_t, uint32_t>> TreeEdges;
+        edges.ForEachEdge([&](uint32_t u, uint32_t w) {
+            if (trees.Find(u) != trees.Find(w))
+            {
+                trees.Union(u, w);
+                TreeEdges.push_back({u, w});
+            }
+        });
+        for (auto &e : TreeEdges)
+        {
+            ++ForestStart[e.first + 1];
+            ++ForestStart[e.second + 1];
+        }
+        for (uint32_t v = 0; v < n; ++v)
+        {
+            ForestStart[v + 1] += ForestStart[v];
+        }
+        forest.resize(ForestStart[n]);
+        std::vector<uint32_t> fill(ForestStart.begin(), ForestStart.end() - 1);
+        for (auto &e : TreeEdges)
+        {
+            forest[fill[e.first]++] = e.second;
+            forest[fill[e.second]++] = e.first;
+        }
+    }
+
+    // breadth-first from the smallest vertex of each tree: order lists the trees one after the other, and the
+    // children of every vertex lie next to each other in it
+    phase.Next("semi-external numbering");
+    std::vector<uint32_t> parent(n, UINT32_MAX);
+    std::vector<uint32_t> order;
+    order.reserve(n);
+    {
+        VertexFlags seen(n);
+        for (uint32_t root = seen.NextClear(0); root < n; root = seen.NextClear(root + 1))
+        {
+            size_t head = order.size();
+            seen.Set(root);
+            order.push_back(root);
+            while (head < order.size())
+            {
+                uint32_t v = order[head++];
+                for (uint32_t i = ForestStart[v]; i < ForestStart[v + 1]; ++i)
+                {
+                    if (seen.TestAndSet(forest[i]))
+                    {
+                        parent[forest[i]] = v;
+                        order.push_back(forest[i]);
+                    }
+                }
+            }
+        }
+    }
+    std::vector<uint32_t>().swap(forest);
+    std::vector<uint32_t>().swap(ForestStart);
+
+    // subtree sizes bottom-up, then preorder numbers top-down; j runs over the children of order[i]
+    std::vector<uint32_t> size(n, 1);
+    for (size_t i = n; i-- > 0;)
+    {
+        if (parent[order[i]] != UINT32_MAX)
+            size[parent[order[i]]] += size[order[i]];
+    }
+    std::vector<uint32_t> pre(n);
+    uint32_t next = 0;
+    for (size_t i = 0, j = 0; i < n; ++i)
+    {
+        uint32_t v = order[i];
+        if (parent[v] == UINT32_MAX)
+        {
+            pre[v] = next;
+            next += size[v];
+            j = i + 1;
+        }
+        uint32_t number = pre[v] + 1;
+        for (; j < n && parent[order[j]] == v; ++j)
+        {
+            pre[order[j]] = number;
+            number += size[order[j]];
+        }
+    }
+
+    // 2. low and high
+    phase.Next("semi-external low/high");
+    auto IsTreeEdge = [&](uint32_t v, uint32_t w) { return parent[w] == v || parent[v] == w; };
+    std::vector<uint32_t> low(pre), high(pre);
+    edges.ForEachEdge([&](uint32_t u, uint32_t w) {
+        if (IsTreeEdge(u, w))
+            return;
+        low[u] = std::min(low[u], pre[w]);
+        high[u] = std::max(high[u], pre[w]);
+        low[w] = std::min(low[w], pre[u]);
+        high[w] = std::max(high[w], pre[u]);
+    });
+    for (size_t i = n; i-- > 0;)
+    {
+        uint32_t v = order[i], p = parent[v];
+        if (p == UINT32_MAX)
+            continue;
+        low[p] = std::min(low[p], low[v]);
+        high[p] = std::max(high[p], high[v]);
+    }
+
+    // 3. the auxiliary graph
+    phase.Next("semi-external auxiliary graph");
+    ConcurrentUnionFind blocks(n);
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        uint32_t p = parent[v];
+        if (p != UINT32_MAX && parent[p] != UINT32_MAX && (low[v] < pre[p] || high[v] >= pre[p] + size[p]))
+            blocks.Union(v, p);
+    }
+    edges.ForEachEdge([&](uint32_t u, uint32_t w) {
+        uint32_t first = pre[u] < pre[w] ? u : w, second = first == u ? w : u;
+        if (pre[second] >= pre[first] + size[first] && !IsTreeEdge(u, w))
+            blocks.Union(u, w);
+    });
+
+    std::vector<uint32_t> label(n, UINT32_MAX);
+    uint64_t NumComponents = 0;
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        if (parent[v] != UINT32_MAX)
+        {
+            label[v] = blocks.Find(v);
+            NumComponents += label[v] == v;
+        }
+    }
+    VertexFlags IsArticulation(n);
+    std::vector<std::pair<uint32_t, uint32_t>> bridges;
+    uint32_t FirstChildLabel = UINT32_MAX; // of the root whose children order[i] is among
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint32_t v = order[i], p = parent[v];
+        if (p == UINT32_MAX)
+            continue;
+        if (parent[p] == UINT32_MAX && parent[order[i - 1]] != p)
+            FirstChildLabel = label[v];
+        // p separates v's component from another one at p: its parent edge's, or for a root, its first child's
+        if (label[v] != (parent[p] != UINT32_MAX ? label[p] : FirstChildLabel))
+            IsArticulation.Set(p);
+        // nothing leaves the subtree of v
+        if (low[v] >= pre[v] && high[v] < pre[v] + size[v])
+            bridges.push_back({std::min(p, v), std::max(p, v)});
+    }
+    std::sort(bridges.begin(), bridges.end());
+    std::vector<uint32_t>().swap(low);
+    std::vector<uint32_t>().swap(high);
+    std::vector<uint32_t>().swap(order);
+    CountEvent("vertices visited", n);
+
+    std::vector<uint32_t> points;
+    IsArticulation.ForEach([&points](uint32_t v) { points.push_back(v); });
+    phase.Next("print");
+    PrintCutsAndBridges(out, points, bridges, NumComponents, verbosity);
+    if (verbosity == VERBOSITY_FULL)
+    {
+        // 4. the components numbered by their smallest edge, and their sizes
+        phase.Next("semi-external components");
+        auto ComponentOf = [&](uint32_t u, uint32_t w) {
+            if (parent[w] == u)
+                return label[w];
+            if (parent[u] == w)
+                return label[u];
+            return pre[u] > pre[w] ? label[u] : label[w];
+        };
+        std::vector<uint32_t> CanonicalId(n, UINT32_MAX);
+        std::vector<uint64_t> offsets{0};
+        edges.ForEachEdge([&](uint32_t u, uint32_t w) {
+            uint32_t &id = CanonicalId[ComponentOf(u, w)];
+            if (id == UINT32_MAX)
+            {
+                id = static_cast<uint32_t>(offsets.size() - 1);
+                offsets.push_back(0);
+            }
+            ++offsets[id + 1];
+        });
+        for (size_t c = 1; c < offsets.size(); ++c)
+        {
+            offsets[c] += offsets[c - 1];
+        }
+
+        // 5. the edges of each component, on disk
+        WritableMappedFile scratch;
+        CreateScratchFile(scratch, offsets.back() * 2 * sizeof(uint32_t));
+        auto placed = reinterpret_cast<uint32_t *>(scratch.data);
+        std::vector<uint64_t> fill(offsets.begin(), offsets.end() - 1);
+        edges.ForEachEdge([&](uint32_t u, uint32_t w) {
+            uint64_t e = fill[CanonicalId[ComponentOf(u, w)]]++;
+            placed[2 * e] = u;
+            placed[2 * e + 1] = w;
+        });
+        phase.Next("print");
+        out << "Biconnected components: " << NumComponents << '\n';
+        for (size_t c = 0; c + 1 < offsets.size(); ++c)
+        {
+            out << "Component " << uint64_t(c) << ':';
+            for (uint64_t e = offsets[c]; e < offsets[c + 1]; ++e)
+            {
+                out << ' ' << placed[2 * e] << '-' << placed[2 * e + 1];
+            }
+            out << '\n';
+        }
+    }
+    CountEvent("edge passes", edges.passes);
+    CountEvent("edges streamed", edges.EdgesStreamed);
+}
+
+#endif
@@ -1,185 +1,230 @@
+#include "AllocationCounting.h"
+#include "Batch.h"
+#include "DynamicBiconnectivity.h"
+#include "TarjanHopcroft.h"
+#include "TarjanVishkin.h"
+#include "Loader.h"
+#include "OutputWriter.h"
+#include "QueryServer.h"
+#include "Reorder.h"
+#include "SemiExternal.h"
 #include "utils.h"
 
 using std::cerr;
 using std::cin;
 using std::cout;
 
-void CheckArgs(int argc, char *argv[])
+struct Options
 {
-    if (argc != 2)
+    char *InputPath = nullptr;
+    std::string Engine = "linear"; // linear | parallel | legacy | semi-external
+    const char *StatsPath = nullptr; // --stats=<path>: write instrumentation as JSON
+    Verbosity Output = VERBOSITY_FULL; // --output=summary|cut|bridges|full
+    const char *BinaryOutputPath = nullptr; // --binary-output=<path>: also write the result as a binary file
+    const char *UpdatesPath = nullptr; // --updates=<path>: batches of edges to insert or delete after the analysis
+    VertexOrder Reorder = ORDER_NONE; // --reorder=bfs|rcm|degree|dfs: relabel the vertices before the analysis
+    unsigned NumThreads = std::thread::hardware_concurrency(); // for loading text input and the parallel engine
+};
+
+void CheckArgs(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *value;
+        if (MatchOption(argv[i], "--engine", value))
+        {
+            options.Engine = value;
+        }
+        else if (MatchOption(argv[i], "--stats", value))
+        {
+            options.StatsPath = value;
+        }
+        else if (MatchOption(argv[i], "--output", value))
+        {
+            if (!ParseVerbosity(value, options.Output))
+            {
+                cout << "--output expects summary, cut, bridges or full\n";
+                exit(1);
+            }
+        }
+        else if (MatchOption(argv[i], "--binary-output", value))
+        {
+            options.BinaryOutputPath = value;
+        }
+        else if (MatchOption(argv[i], "--updates", value))
+        {
+            options.UpdatesPath = value;
+        }
+        else if (MatchOption(argv[i], "--reorder", value))
+        {
+            if (!ParseVertexOrder(value, options.Reorder))
+            {
+                cout << "--reorder expects none, bfs, rcm, degree or dfs\n";
+                exit(1);
+            }
+        }
+        else if (MatchOption(argv[i], "--threads", value))
+        {
+            options.NumThreads = ParseThreadCount(value);
+            if (options.NumThreads == 0)
+            {
+                cout << "--threads expects a positive number\n";
+                exit(1);
+            }
+        }
+        else if (argv[i][0] == '-' || options.InputPath != nullptr)
+        {
+            options.InputPath = nullptr;
+            break;
+        }
+        else
+        {
+            options.InputPath = argv[i];
+        }
+    }
+
+    if (options.InputPath == nullptr)
+    {
+        cout << "Usage: ./tarjan [--engine=linear|parallel|legacy|semi-external] [--threads=N] [--output=summary|cut|bridges|full]\n"
+                "              [--reorder=none|bfs|rcm|degree|dfs] [--binary-output=result.bin] [--updates=edges.txt]\n"
+                "              [--stats=stats.json] file_path.in|file_path.mtx|file_path.bcsr\n";
+        cout << "       ./tarjan convert file_path.in|file_path.mtx output.bcsr [--degree-order] [--id-bytes=2|4|8] [--threads=N]\n";
+        cout << "       ./tarjan serve file_path.in|file_path.mtx|file_path.bcsr [--socket=path] [--threads=N]\n";
+        cout << "       ./tarjan batch manifest.txt|directory [--output=summary|cut|bridges|full] [--threads=N] [--stats=stats.json]\n";
+        exit(1);
+    }
+    else if (!EndsWith(options.InputPath, ".in") && !EndsWith(options.InputPath, ".mtx") && !EndsWith(options.InputPath, ".bcsr"))
+    {
+        cout << "The file must end in .in, .mtx or .bcsr\n";
+        exit(1);
+    }
+    else if (options.Engine != "linear" && options.Engine != "parallel" && options.Engine != "legacy" && options.Engine != "semi-external")
+    {
+        cout << "Unknown engine " << options.Engine << "\n";
+        exit(1);
+    }
+    else if (options.Engine == "semi-external" && !EndsWith(options.InputPath, ".bcsr"))
+    {
+        cout << "The semi-external engine streams the edges of a binary graph; write one with ./tarjan convert or ./gengraph\n";
+        exit(1);
+    }
+    else if (options.Engine == "semi-external" && (options.BinaryOutputPath != nullptr || options.UpdatesPath != nullptr || options.Reorder != ORDER_NONE))
+    {
+        cout << "The semi-external engine keeps no graph or edge labels in memory, so it cannot be combined with --binary-output, --updates or --reorder\n";
+        exit(1);
+    }
+    else if (options.Engine == "legacy" && options.BinaryOutputPath != nullptr)
     {
-        cout << "Usage: ./tarjan file_path.in\n";
+        cout << "The legacy engine prints no result, so it has none to write with --binary-output\n";
         exit(1);
     }
-    else if (!(strlen(argv[1]) >= 3 && !strcmp(argv[1] + strlen(argv[1]) - 3, ".in")))
+    else if (options.Engine == "legacy" && options.UpdatesPath != nullptr)
     {
-        cout << "The file must end in .in\n";
+        cout << "The legacy engine has no block-cut tree to update with --updates\n";
+        exit(1);
+    }
+    else if (options.Engine == "legacy" && options.Reorder != ORDER_NONE)
+    {
+        cout << "The legacy engine prints its DFS forest in the input ids, so it cannot run on a reordered graph\n";
         exit(1);
     }
 }
 
 void MakeDFSForest(Graph &graph)
 {
-    std::unordered_set<uint32_t> unvisited; // unvisited nodes
-    unvisited.reserve(graph.n);
-    for (uint32_t i = 0; i < graph.n; ++i)
-    {
-        unvisited.insert(i);
-    }
+    ScopedPhase phase("dfs");
+    uint64_t VerticesVisited = 0, EdgesScanned = 0;
+    size_t StackHighWater = 0;
+    auto &state = graph.State;
+    state.Reset(graph.n);
+    VertexFlags visited(graph.n);
+    std::stack<std::pair<uint32_t, uint32_t>, std::vector<std::pair<uint32_t, uint32_t>>> s; // stack<pair<cur, prev>> to get the DFS trees
 
-    while (!unvisited.empty())
+    // every tree is rooted at the lowest vertex not visited yet, so the forest depends on the input alone
+    for (uint32_t root = visited.NextClear(0); root < graph.n; root = visited.NextClear(root + 1))
     {
-        auto root = unvisited.begin();
-        graph.DFSForest.push_back(Tree(*root)); // create a new tree
+        graph.DFSForest.push_back(Tree(root)); // create a new tree
         auto &curTree = graph.DFSForest.back();
+        uint32_t CurTreeNum = static_cast<uint32_t>(graph.DFSForest.size() - 1);
         uint32_t DiscoveryTime = 1;
 
-        // find curTree, a DFS tree rooted at *root
-        std::stack<std::pair<uint32_t, uint32_t>> s; // stack<pair<cur, prev>> to get the DFS tree
-        s.push({*root, UINT32_MAX});
+        // find curTree, a DFS tree rooted at root
+        s.push({root, UINT32_MAX});
         while (!s.empty())
         {
             uint32_t v = s.top().first;
             uint32_t prev = s.top().second;
+            StackHighWater = std::max(StackHighWater, s.size());
             s.pop();
-            if (unvisited.find(v) != unvisited.end())
+            if (visited.TestAndSet(v))
             {
-                unvisited.erase(v); // mark v as visited
-                if (prev == UINT32_MAX)
-                {
-                    // v is the root
-                    curTree.AdjMap.insert({v, Tree::PointProperties(DiscoveryTime)});
-
-                    ++DiscoveryTime;
-
-                    graph.TreeNum.at(v) = static_cast<uint32_t>(graph.DFSForest.size() - 1);
-                }
-                else
+                ++VerticesVisited;
+                state.DiscoveryTime[v] = DiscoveryTime;
+                ++DiscoveryTime;
+                state.TreeNum[v] = CurTreeNum;
+                ++curTree.NumVertices;
+                if (prev != UINT32_MAX)
                 {
                     // v is not the root
-                    if (curTree.AdjMap.count(prev) == 0)
-                    {
-                        cerr << "Error: prev not present in the map!\n";
-                        exit(1);
-                    }
-
-                    try
-                    {
-                        curTree.AdjMap.at(prev).neighbours.push_back(v);
-                    }
-                    catch (const std::out_of_range &e)
-                    {
-                        std::cerr << "Error: Prev (" << prev << ") not present in the map: " << e.what() << "\n";
-                        exit(1);
-                    }
-
-                    if (curTree.AdjMap.count(v) == 0)
-                    {
-                        curTree.AdjMap.insert({v, Tree::PointProperties(DiscoveryTime)});
-                        ++DiscoveryTime;
-
-                        graph.TreeNum.at(v) = static_cast<uint32_t>(graph.DFSForest.size() - 1);
-                    }
+                    state.AddChild(prev, v);
                 }
 
-                for (uint32_t i = 0; i < graph.AdjList.at(v).size(); ++i)
+                for (auto w : graph.Adj(v))
                 {
-                    if (unvisited.find(graph.AdjList[v][i]) != unvisited.end())
-                        s.push({graph.AdjList[v][i], v}); // push w for all edges vw
+                    ++EdgesScanned;
+                    if (!visited[w])
+                        s.push({w, v}); // push w for all edges vw
                 }
             }
         }
     }
+    CountEvent("vertices visited", VerticesVisited);
+    CountEvent("edges scanned", EdgesScanned);
+    RecordMaximum("stack high-water", StackHighWater);
 }
 
-void LoadGraph(std::ifstream &InputFile, Graph &graph)
+// LevelOrder is scratch space, shared by all the trees
+void FindLowTree(Tree &tree, Graph &graph, std::vector<uint32_t> &LevelOrder)
 {
-    SkipNLines(InputFile, 1, std::ios::beg);
-    std::string line;
-    line.reserve(graph.n * 2);
-
-    uint32_t i = 0;
-    while (std::getline(InputFile, line))
-    {
-        std::stringstream stream(line);
-        uint32_t j = 0;
-        while (stream >> j)
-        {
-            graph.AdjList.at(i).push_back(j);
-            ++graph.m;
-        }
-        ++i;
-    }
-
-    assert(graph.AdjList.size() == graph.n);
-}
-
-void LevelOrderTraversal(const Tree &tree, std::vector<uint32_t> &LevelOrder)
-{
-    // Performs BFS
-    LevelOrder.reserve(tree.AdjMap.size());
-    std::queue<uint32_t> q;
-
-    uint32_t root = tree.root;
-    q.push(root);
-
-    while (!q.empty())
-    {
-        auto &v = q.front();
-        LevelOrder.push_back(v);
-        q.pop();
-        for (auto &neighbour : tree.AdjMap.at(v).neighbours)
-        {
-            q.push(neighbour);
-        }
-    }
-
-    assert(LevelOrder.size() == tree.AdjMap.size());
-}
-
-void FindLowTree(Tree &tree, const Graph &graph)
-{
-    std::vector<uint32_t> LevelOrder;
-    LevelOrderTraversal(tree, LevelOrder);
+    auto &state = graph.State;
+    LevelOrderTraversal(tree, state, LevelOrder);
     PrintLevelOrderTraversal(LevelOrder);
     
     for (auto node = LevelOrder.rbegin(); node != LevelOrder.rend(); ++node)
     {
-        auto &CurNode = tree.AdjMap.at(*node);
-        CurNode.Low = CurNode.DiscoveryTime;
+        uint32_t &CurLow = state.Low[*node];
+        CurLow = state.DiscoveryTime[*node];
 
         // iterate over children of CurNode
         uint32_t MaxLowOfChildren = 0;
-        for (auto &child : CurNode.neighbours)
+        uint32_t NumChildren = 0;
+        for (uint32_t child = state.FirstChild[*node]; child != UINT32_MAX; child = state.NextSibling[child])
         {
-            auto &ChildNode = tree.AdjMap.at(child);
-            CurNode.Low = std::min(CurNode.Low, ChildNode.Low);
-            MaxLowOfChildren = std::max(MaxLowOfChildren, ChildNode.Low);
+            CurLow = std::min(CurLow, state.Low[child]);
+            MaxLowOfChildren = std::max(MaxLowOfChildren, state.Low[child]);
+            ++NumChildren;
         }
-        if (MaxLowOfChildren >= CurNode.DiscoveryTime &&
-            CurNode.neighbours.size() > 0 &&
-            !(tree.root == *node && CurNode.neighbours.size() == 1)
+        if (MaxLowOfChildren >= state.DiscoveryTime[*node] &&
+            NumChildren > 0 &&
+            !(tree.root == *node && NumChildren == 1)
             /* not a node with only 1 neighbour */)
         {
-            tree.ArticulationPoints.insert(*node);
+            state.IsArticulation.Set(*node);
         }
 
         // iterate over back edges of CurNode
-        auto &children = tree.AdjMap.at(*node).neighbours;
-        auto &neighbours = graph.AdjList.at(*node);
-        for (auto &neighbour : neighbours)
+        for (auto neighbour : graph.Adj(*node))
         {
-            auto &ChildrenOfNeighbour = tree.AdjMap.at(neighbour).neighbours;
             if (
-                std::find(children.begin(), children.end(), neighbour) == children.end()
+                state.Parent[neighbour] != *node
                 /* is a neighbour but a not a child */
                 &&
-                std::find(ChildrenOfNeighbour.begin(), ChildrenOfNeighbour.end(), *node) == ChildrenOfNeighbour.end()
+                state.Parent[*node] != neighbour
                 /* is not a parent */)
             {
                 // CurNode is a back edge
                 // note: the edge to the parent is *NOT* a back edge as the graph is undirected
-                CurNode.Low = std::min(CurNode.Low, tree.AdjMap.at(neighbour).DiscoveryTime);
+                CurLow = std::min(CurLow, state.DiscoveryTime[neighbour]);
             }
         }
     }
@@ -187,31 +232,160 @@ void FindLowTree(Tree &tree, const Graph &graph)
 
 void FindLow(Graph &graph)
 {
+    ScopedPhase phase("low");
+    std::vector<uint32_t> LevelOrder;
     for (auto &tree : graph.DFSForest)
     {
-        FindLowTree(tree, graph);
+        FindLowTree(tree, graph, LevelOrder);
     }
 }
 
-int main(int argc, char *argv[])
+// Applies the batches of edge insertions and deletions of --updates to the analysed graph one batch at a time,
+// reporting the counts after each, and leaves the result for the graph with all of them in result.
+void ApplyUpdates(const Graph &graph, BiconnectivityResult &result, const char *UpdatesPath, OutputWriter &out)
 {
-    CheckArgs(argc, argv);
+    std::vector<std::vector<EdgeUpdate>> batches;
+    LoadUpdateBatches(UpdatesPath, graph.n, batches);
 
-    std::ifstream InputFile;
-    OpenInputFile(InputFile, argv[1]);
+    ScopedPhase phase("dynamic build");
+    BlockCutTree tree;
+    BuildBlockCutTree(graph, result, tree);
+    DynamicBiconnectivity dynamic;
+    dynamic.Build(graph, result, tree);
+    phase.Next("updates");
+    for (size_t i = 0; i < batches.size(); ++i)
+    {
+        Timer t;
+        dynamic.ApplyBatch(batches[i]);
+        auto us = static_cast<uint64_t>(t.StopMicroseconds());
+        out << "Batch " << uint64_t(i) << ": " << uint64_t(batches[i].size()) << " updates, " << dynamic.NumArticulationPoints
+            << " articulation points, " << dynamic.NumBridges << " bridges, " << dynamic.NumBlocks
+            << " biconnected components, " << us << " us\n";
+        CountEvent("edge updates", batches[i].size());
+    }
+    phase.Next("component lists");
+    dynamic.GetResult(result);
+}
 
-    uint32_t n;                // number of vertices
-    InputFile >> n >> std::ws; // skip the whitespace at the end of the line before switching to line-based reading using getline
+// Runs the linear engine on a binary graph in the id widths it is stored in: a graph with fewer than 65535
+// vertices is analysed in 16-bit ids, one with 2^32 edges or more in 64-bit offsets. Options that need the
+// other engines or 32-bit results (--reorder, --updates, --binary-output) load the graph as 32-bit instead.
+template <typename VertexId, typename EdgeId>
+void AnalyseAtStoredWidth(const Options &options)
+{
+    BasicGraph<VertexId, EdgeId> graph(0);
+    {
+        ScopedPhase phase("load");
+        graph = LoadBinaryGraph<VertexId, EdgeId>(options.InputPath);
+    }
+    MakeUndirected(graph);
+    BasicBiconnectivityResult<VertexId, EdgeId> result;
+    TarjanHopcroft(graph, result);
+    OutputWriter out;
+    ScopedPhase phase("print");
+    PrintBiconnectivity(out, result, options.Output);
+}
 
-    Graph graph(n);
-    LoadGraph(InputFile, graph);
+// true if the graph was analysed in ids narrower or wider than 32 bits, false if it is left to the 32-bit path
+bool AnalyseBinaryGraphAtStoredWidth(const Options &options)
+{
+    if (!EndsWith(options.InputPath, ".bcsr") || options.Engine != "linear" || options.Reorder != ORDER_NONE ||
+        options.UpdatesPath != nullptr || options.BinaryOutputPath != nullptr)
+        return false;
+    BinaryGraphHeader header = ReadBinaryGraphHeader(options.InputPath);
+    if (header.VertexIdBytes == 2)
+        AnalyseAtStoredWidth<uint16_t, uint32_t>(options);
+    else if (header.VertexIdBytes == 8)
+        AnalyseAtStoredWidth<uint64_t, uint64_t>(options);
+    else if (header.OffsetBytes() == 8)
+        AnalyseAtStoredWidth<uint32_t, uint64_t>(options);
+    else
+        return false;
+    return true;
+}
+
+// one graph of a batch, with the linear engine
+void AnalyseInBatch(Graph &graph, BiconnectivityResult &result, OutputWriter &out, Verbosity verbosity)
+{
+    TarjanHopcroft(graph, result);
+    PrintBiconnectivity(out, result, verbosity);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 2 && !strcmp(argv[1], "convert"))
+        return ConvertMain(argc, argv, "./tarjan");
+    if (argc >= 2 && !strcmp(argv[1], "serve"))
+        return ServeMain(argc, argv, "./tarjan");
+    if (argc >= 2 && !strcmp(argv[1], "batch"))
+        return BatchMain(argc, argv, "./tarjan", AnalyseInBatch);
+
+    std::ios::sync_with_stdio(false);
+    Options options;
+    CheckArgs(argc, argv, options);
+    if (options.StatsPath != nullptr)
+        EnableInstrumentation();
+    if (options.Engine == "semi-external")
+    {
+        OutputWriter out;
+        SemiExternalBiconnectivity(options.InputPath, out, options.Output);
+    }
+    if (options.Engine == "semi-external" || AnalyseBinaryGraphAtStoredWidth(options))
+    {
+        if (options.StatsPath != nullptr)
+            WriteInstrumentationJson(options.StatsPath);
+        return 0;
+    }
+
+    Graph graph = LoadGraph(options.InputPath, options.NumThreads);
     PrintGraph(graph);
 
-    MakeDFSForest(graph);
-    FindLow(graph);
+    if (options.Engine == "legacy")
+    {
+        MakeDFSForest(graph);
+        FindLow(graph);
+    }
+    else
+    {
+        MakeUndirected(graph);
+        BiconnectivityResult result;
+        auto analyse = [&options, &result](Graph &analysed) {
+            if (options.Engine == "parallel")
+            {
+                ThreadPool pool(options.NumThreads);
+                TarjanVishkin(analysed, result, pool);
+            }
+            else
+            {
+                TarjanHopcroft(analysed, result);
+            }
+        };
+        if (options.Reorder == ORDER_NONE)
+        {
+            analyse(graph);
+        }
+        else
+        {
+            VertexRelabelling relabelling;
+            Graph relabelled = RelabelGraph(graph, options.Reorder, relabelling);
+            analyse(relabelled);
+            relabelled = Graph(0); // the original graph is still needed, for the result and for --updates
+            MapResultBack(graph, relabelling, result);
+        }
+        {
+            OutputWriter out;
+            if (options.UpdatesPath != nullptr)
+                ApplyUpdates(graph, result, options.UpdatesPath, out);
+            ScopedPhase phase("print");
+            PrintBiconnectivity(out, result, options.Output);
+        }
+        if (options.BinaryOutputPath != nullptr)
+            WriteBinaryResult(options.BinaryOutputPath, graph.n, result);
+    }
 
     PrintForest(graph.DFSForest, graph);
 
-    InputFile.close();
+    if (options.StatsPath != nullptr)
+        WriteInstrumentationJson(options.StatsPath);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,126 @@
+#ifndef TARJAN_HOPCROFT_H
+#define TARJAN_HOPCROFT_H
+
+#include "utils.h"
+
+// Iterative single-pass Tarjan-Hopcroft biconnectivity in O(n + m).
+// One explicit-stack DFS computes discovery and low values into graph.State, builds graph.DFSForest,
+// and finds articulation points, bridges and biconnected components. Components are popped off a stack
+// of vertices, each popped vertex labelling the tree edge to its parent; the edge lists are then laid out by
+// BuildComponentLists.
+// The graph must be undirected and simple, see MakeUndirected. Runs at any id width (see BasicGraph).
+template <typename VertexId, typename EdgeId>
+void TarjanHopcroft(BasicGraph<VertexId, EdgeId> &graph, BasicBiconnectivityResult<VertexId, EdgeId> &result)
+{
+    ScopedPhase phase("tarjan-hopcroft dfs");
+    auto &state = graph.State;
+    state.Reset(graph.n);
+    graph.DFSForest.clear();
+    result.Clear();
+
+    struct Frame
+    {
+        VertexId v;
+        EdgeId next;           // position in AdjArray of the next edge of v to look at
+        bool SkippedParent;    // the tree edge back to the parent has been skipped once
+    };
+    std::vector<Frame> stack;
+    std::vector<VertexId> VertexStack;
+    std::vector<VertexId> label(graph.n, NoId<VertexId>); // component of the tree edge to the parent
+    VertexId NumComponents = 0;
+    VertexId DiscoveryTime = 1;
+    uint64_t EdgesScanned = 0;
+    size_t StackHighWater = 0;
+
+    for (VertexId root = 0; root < graph.n; ++root)
+    {
+        if (state.DiscoveryTime[root] != NoId<VertexId>)
+            continue;
+
+        graph.DFSForest.push_back(BasicTree<VertexId>(root)); // create a new tree
+        auto &curTree = graph.DFSForest.back();
+        VertexId CurTreeNum = static_cast<VertexId>(graph.DFSForest.size() - 1);
+        VertexId RootChildren = 0;
+
+        state.DiscoveryTime[root] = state.Low[root] = DiscoveryTime++;
+        state.TreeNum[root] = CurTreeNum;
+        ++curTree.NumVertices;
+        stack.push_back({root, graph.AdjOffsets[root], false});
+        StackHighWater = std::max<size_t>(StackHighWater, 1);
+
+        while (!stack.empty())
+        {
+            auto &top = stack.back();
+            VertexId v = top.v;
+
+            if (top.next < graph.AdjOffsets[v + 1])
+            {
+                VertexId w = graph.AdjArray[top.next++];
+                ++EdgesScanned;
+                if (w == state.Parent[v] && !top.SkippedParent)
+                {
+                    top.SkippedParent = true; // the tree edge itself, a parallel edge would be a back edge
+                    continue;
+                }
+
+                if (state.DiscoveryTime[w] == NoId<VertexId>)
+                {
+                    // tree edge v-w
+                    state.AddChild(v, w);
+                    state.DiscoveryTime[w] = state.Low[w] = DiscoveryTime++;
+                    state.TreeNum[w] = CurTreeNum;
+                    ++curTree.NumVertices;
+                    if (v == root)
+                        ++RootChildren;
+                    VertexStack.push_back(w);
+                    stack.push_back({w, graph.AdjOffsets[w], false}); // invalidates top
+                    StackHighWater = std::max(StackHighWater, stack.size());
+                }
+                else
+                {
+                    // back edge; seen from the ancestor's side it cannot lower anything
+                    state.Low[v] = std::min(state.Low[v], state.DiscoveryTime[w]);
+                }
+                continue;
+            }
+
+            // v is finished, report to its parent
+            stack.pop_back();
+            VertexId p = state.Parent[v];
+            if (p == NoId<VertexId>)
+                continue;
+
+            state.Low[p] = std::min(state.Low[p], state.Low[v]);
+            if (state.Low[v] >= state.DiscoveryTime[p])
+            {
+                // p separates the subtree of v: the vertices from v up on the stack hang off one component
+                if (p != root)
+                    state.IsArticulation.Set(p);
+                if (state.Low[v] > state.DiscoveryTime[p])
+                    result.Bridges.push_back({std::min(p, v), std::max(p, v)});
+
+                VertexId x;
+                do
+                {
+                    x = VertexStack.back();
+                    VertexStack.pop_back();
+                    label[x] = NumComponents;
+                } while (x != v);
+                ++NumComponents;
+            }
+        }
+
+        if (RootChildren > 1)
+            state.IsArticulation.Set(root);
+    }
+
+    state.IsArticulation.ForEach([&result](VertexId v) { result.ArticulationPoints.push_back(v); });
+    std::sort(result.Bridges.begin(), result.Bridges.end());
+    CountEvent("vertices visited", graph.n);
+    CountEvent("edges scanned", EdgesScanned);
+    RecordMaximum("stack high-water", StackHighWater);
+    phase.Next("component lists");
+    BuildComponentLists(graph, state.Parent, state.DiscoveryTime, label, result);
+}
+
+#endif
@@ -0,0 +1,314 @@
+#ifndef TARJAN_VISHKIN_H
+#define TARJAN_VISHKIN_H
+
+#include "ThreadPool.h"
+#include "utils.h"
+
+// Union-find over 0 ... n - 1 that many threads can update at once.
+// Roots are linked with compare-and-swap, always the larger below the smaller one,
+// so the root of a set is its smallest element. Find halves paths as it goes.
+struct ConcurrentUnionFind
+{
+    std::vector<uint32_t> parent;
+
+    explicit ConcurrentUnionFind(uint32_t n)
+    {
+        parent.resize(n);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            parent[i] = i;
+        }
+    }
+
+    uint32_t Find(uint32_t x)
+    {
+        for (;;)
+        {
+            uint32_t p = __atomic_load_n(&parent[x], __ATOMIC_RELAXED);
+            if (p == x)
+                return x;
+            uint32_t gp = __atomic_load_n(&parent[p], __ATOMIC_RELAXED);
+            if (gp != p)
+                __atomic_compare_exchange_n(&parent[x], &p, gp, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+            x = gp;
+        }
+    }
+
+    void Union(uint32_t a, uint32_t b)
+    {
+        for (;;)
+        {
+            a = Find(a);
+            b = Find(b);
+            if (a == b)
+                return;
+            if (a < b)
+                std::swap(a, b);
+            uint32_t expected = a;
+            if (__atomic_compare_exchange_n(&parent[a], &expected, b, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                return;
+        }
+    }
+};
+
+// Parallel biconnectivity after Tarjan and Vishkin, without depth-first search.
+//  1. connected components with a concurrent union-find, the smallest vertex of each becomes its root
+//  2. a BFS spanning forest, grown from all roots at once one level at a time
+//  3. subtree sizes bottom-up and preorder numbers top-down, level by level (the Euler tour numbering)
+//  4. low / high: the smallest / largest preorder number reachable from a subtree through one non-tree edge
+//  5. connectivity of the auxiliary graph on the tree edges (tree edge (parent[v], v) is represented by v):
+//     - a non-tree edge {v, w} between unrelated subtrees joins the tree edges above v and w,
+//     - tree edges (p, v) and (parent[p], p) are joined when the subtree of v reaches outside the subtree of p.
+// Its classes are the biconnected components. Every step but the final listing of the components
+// (BuildComponentLists) runs on the pool. The results equal those of TarjanHopcroft.
+// The graph must be undirected and simple, see MakeUndirected.
+void TarjanVishkin(Graph &graph, BiconnectivityResult &result, ThreadPool &pool)
+{
+    const uint32_t n = graph.n;
+    const uint64_t grain = 1024; // fewer items than this per block are not worth a thread
+    auto &state = graph.State;
+    state.Reset(n);
+    graph.DFSForest.clear();
+    result.Clear();
+
+    // 1. connected components
+    ScopedPhase phase("tarjan-vishkin connectivity");
+    ConcurrentUnionFind components(n);
+    ParallelFor(pool, n, [&](uint64_t first, uint64_t last) {
+        for (uint64_t v = first; v < last; ++v)
+        {
+            for (auto w : graph.Adj(static_cast<uint32_t>(v)))
+            {
+                if (w > v)
+                    components.Union(static_cast<uint32_t>(v), w);
+            }
+        }
+    }, grain);
+    std::vector<uint32_t> roots;
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        if (components.parent[v] == v)
+            roots.push_back(v);
+    }
+
+    // 2. BFS forest; order lists the vertices level by level, level l being order[LevelStart[l] ... LevelStart[l + 1] - 1]
+    phase.Next("tarjan-vishkin bfs");
+    auto &parent = state.Parent;
+    for (auto r : roots)
+    {
+        parent[r] = r; // claimed, reset below
+    }
+    std::vector<uint32_t> order(roots);
+    order.reserve(n);
+    std::vector<uint64_t> LevelStart{0, roots.size()};
+    for (;;)
+    {
+        uint64_t begin = LevelStart[LevelStart.size() - 2], end = LevelStart.back();
+        if (begin == end)
+            break;
+        uint64_t blocks = std::max<uint64_t>(1, std::min<uint64_t>((end - begin) / grain, uint64_t(pool.Size()) * 4));
+        std::vector<std::vector<uint32_t>> next(blocks);
+        pool.Run(static_cast<uint32_t>(blocks), [&](uint32_t b) {
+            for (uint64_t i = begin + (end - begin) * b / blocks; i < begin + (end - begin) * (b + 1) / blocks; ++i)
+            {
+                uint32_t v = order[i];
+                for (auto w : graph.Adj(v))
+                {
+                    uint32_t unclaimed = UINT32_MAX;
+                    if (__atomic_load_n(&parent[w], __ATOMIC_RELAXED) == UINT32_MAX &&
+                        __atomic_compare_exchange_n(&parent[w], &unclaimed, v, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                        next[b].push_back(w);
+                }
+            }
+        });
+        for (auto &level : next)
+        {
+            order.insert(order.end(), level.begin(), level.end());
+        }
+        LevelStart.push_back(order.size());
+    }
+    LevelStart.pop_back(); // the empty last level
+    for (auto r : roots)
+    {
+        parent[r] = UINT32_MAX;
+    }
+    auto ForLevel = [&](size_t l, const std::function<void(uint32_t)> &fn) {
+        uint64_t begin = LevelStart[l];
+        ParallelFor(pool, LevelStart[l + 1] - begin, [&](uint64_t first, uint64_t last) {
+            for (uint64_t i = first; i < last; ++i)
+            {
+                fn(order[begin + i]);
+            }
+        }, grain);
+    };
+    size_t NumLevels = LevelStart.size() - 1;
+
+    // children lists, CSR style
+    CountEvent("bfs levels", NumLevels);
+    phase.Next("tarjan-vishkin numbering");
+    std::vector<uint32_t> ChildStart(n + 1, 0);
+    ParallelFor(pool, n, [&](uint64_t first, uint64_t last) {
+        for (uint64_t v = first; v < last; ++v)
+        {
+            if (parent[v] != UINT32_MAX)
+                __atomic_fetch_add(&ChildStart[parent[v]], 1, __ATOMIC_RELAXED);
+        }
+    }, grain);
+    ParallelPrefixSum(pool, ChildStart.data(), ChildStart.size());
+    std::vector<uint32_t> children(ChildStart[n]);
+    std::vector<uint32_t> fill(ChildStart.begin(), ChildStart.end() - 1);
+    ParallelFor(pool, n, [&](uint64_t first, uint64_t last) {
+        for (uint64_t v = first; v < last; ++v)
+        {
+            if (parent[v] != UINT32_MAX)
+                children[__atomic_fetch_add(&fill[parent[v]], 1, __ATOMIC_RELAXED)] = static_cast<uint32_t>(v);
+        }
+    }, grain);
+
+    // 3. subtree sizes, then preorder numbers
+    std::vector<uint32_t> size(n, 1);
+    for (size_t l = NumLevels; l-- > 0;)
+    {
+        ForLevel(l, [&](uint32_t v) {
+            for (uint32_t i = ChildStart[v]; i < ChildStart[v + 1]; ++i)
+            {
+                size[v] += size[children[i]];
+            }
+        });
+    }
+    std::vector<uint32_t> pre(n);
+    uint32_t next = 0;
+    for (auto r : roots)
+    {
+        pre[r] = next;
+        next += size[r];
+    }
+    for (size_t l = 0; l < NumLevels; ++l)
+    {
+        ForLevel(l, [&](uint32_t v) {
+            uint32_t number = pre[v] + 1;
+            for (uint32_t i = ChildStart[v]; i < ChildStart[v + 1]; ++i)
+            {
+                pre[children[i]] = number;
+                number += size[children[i]];
+            }
+        });
+    }
+
+    // 4. low and high
+    phase.Next("tarjan-vishkin low/high");
+    auto IsTreeEdge = [&](uint32_t v, uint32_t w) { return parent[w] == v || parent[v] == w; };
+    std::vector<uint32_t> low(n), high(n);
+    ParallelFor(pool, n, [&](uint64_t first, uint64_t last) {
+        for (uint64_t i = first; i < last; ++i)
+        {
+            uint32_t v = static_cast<uint32_t>(i);
+            low[v] = high[v] = pre[v];
+            for (auto w : graph.Adj(v))
+            {
+                if (!IsTreeEdge(v, w))
+                {
+                    low[v] = std::min(low[v], pre[w]);
+                    high[v] = std::max(high[v], pre[w]);
+                }
+            }
+        }
+    }, grain);
+    for (size_t l = NumLevels; l-- > 0;)
+    {
+        ForLevel(l, [&](uint32_t v) {
+            for (uint32_t i = ChildStart[v]; i < ChildStart[v + 1]; ++i)
+            {
+                low[v] = std::min(low[v], low[children[i]]);
+                high[v] = std::max(high[v], high[children[i]]);
+            }
+        });
+    }
+
+    // 5. the auxiliary graph
+    phase.Next("tarjan-vishkin auxiliary graph");
+    ConcurrentUnionFind blocks(n);
+    ParallelFor(pool, n, [&](uint64_t first, uint64_t last) {
+        for (uint64_t i = first; i < last; ++i)
+        {
+            uint32_t v = static_cast<uint32_t>(i);
+            uint32_t p = parent[v];
+            if (p != UINT32_MAX && parent[p] != UINT32_MAX && (low[v] < pre[p] || high[v] >= pre[p] + size[p]))
+                blocks.Union(v, p);
+            for (auto w : graph.Adj(v))
+            {
+                if (pre[v] < pre[w] && pre[w] >= pre[v] + size[v] && !IsTreeEdge(v, w))
+                    blocks.Union(v, w);
+            }
+        }
+    }, grain);
+
+    std::vector<uint32_t> label(n, UINT32_MAX);
+    std::vector<uint8_t> IsArticulation(n, 0);
+    std::vector<uint8_t> IsBridge(n, 0); // the tree edge (parent[v], v) is a bridge
+    ParallelFor(pool, n, [&](uint64_t first, uint64_t last) {
+        for (uint64_t i = first; i < last; ++i)
+        {
+            uint32_t v = static_cast<uint32_t>(i);
+            if (parent[v] != UINT32_MAX)
+                label[v] = blocks.Find(v);
+        }
+    }, grain);
+    ParallelFor(pool, n, [&](uint64_t first, uint64_t last) {
+        for (uint64_t i = first; i < last; ++i)
+        {
+            uint32_t v = static_cast<uint32_t>(i);
+            uint32_t p = parent[v];
+            if (p == UINT32_MAX)
+                continue;
+            // p separates v's component from another one at p: its parent edge's, or for a root, its first child's
+            uint32_t other = parent[p] != UINT32_MAX ? label[p] : label[children[ChildStart[p]]];
+            if (label[v] != other)
+                __atomic_store_n(&IsArticulation[p], 1, __ATOMIC_RELAXED);
+            // nothing leaves the subtree of v
+            if (low[v] >= pre[v] && high[v] < pre[v] + size[v])
+                IsBridge[v] = 1;
+        }
+    }, grain);
+
+    // the forest in graph.State and graph.DFSForest; DiscoveryTime holds the 1-based preorder number
+    phase.Next("tarjan-vishkin forest");
+    ParallelFor(pool, n, [&](uint64_t first, uint64_t last) {
+        for (uint64_t i = first; i < last; ++i)
+        {
+            uint32_t v = static_cast<uint32_t>(i);
+            state.DiscoveryTime[v] = pre[v] + 1;
+            state.Low[v] = low[v] + 1;
+            for (uint32_t c = ChildStart[v]; c < ChildStart[v + 1]; ++c)
+            {
+                state.NextSibling[children[c]] = c + 1 < ChildStart[v + 1] ? children[c + 1] : UINT32_MAX;
+            }
+            state.FirstChild[v] = ChildStart[v] < ChildStart[v + 1] ? children[ChildStart[v]] : UINT32_MAX;
+        }
+    }, grain);
+    for (uint32_t t = 0; t < roots.size(); ++t)
+    {
+        graph.DFSForest.push_back(Tree(roots[t]));
+        graph.DFSForest.back().NumVertices = size[roots[t]];
+    }
+    ParallelFor(pool, n, [&](uint64_t first, uint64_t last) {
+        for (uint64_t v = first; v < last; ++v)
+        {
+            state.TreeNum[v] = static_cast<uint32_t>(std::lower_bound(roots.begin(), roots.end(), components.Find(static_cast<uint32_t>(v))) - roots.begin());
+        }
+    }, grain);
+
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        if (IsArticulation[v])
+            result.ArticulationPoints.push_back(v);
+        if (IsBridge[v])
+            result.Bridges.push_back({std::min(v, parent[v]), std::max(v, parent[v])});
+    }
+    std::sort(result.Bridges.begin(), result.Bridges.end());
+    CountEvent("vertices visited", n);
+    phase.Next("component lists");
+    BuildComponentLists(graph, parent, pre, label, result);
+}
+
+#endif
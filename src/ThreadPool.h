@@ -0,0 +1,172 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "utils.h"
+
+// A fixed set of worker threads that run one parallel loop at a time.
+// Run(count, fn) calls fn(i) for every i in [0, count), spread over the workers and the calling thread,
+// and returns once all calls are done.
+class ThreadPool
+{
+  public:
+    explicit ThreadPool(unsigned NumThreads = std::thread::hardware_concurrency())
+    {
+        if (NumThreads == 0)
+            NumThreads = 1;
+        for (unsigned i = 1; i < NumThreads; ++i) // the calling thread is the last worker
+        {
+            workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        WakeUp.notify_all();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    unsigned Size() const { return static_cast<unsigned>(workers.size() + 1); }
+
+    void Run(uint32_t count, const std::function<void(uint32_t)> &fn)
+    {
+        if (count == 0)
+            return;
+        if (workers.empty() || count == 1)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                fn(i);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            JobSize = count;
+            next = 0;
+            pending = count;
+            ++generation;
+        }
+        WakeUp.notify_all();
+        Work(fn, count);
+
+        // wait for the workers to leave the job too, so none of them can pick up an index of the next one
+        std::unique_lock<std::mutex> lock(mutex);
+        Done.wait(lock, [this] { return pending == 0 && active == 0; });
+        job = nullptr;
+    }
+
+  private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable WakeUp;
+    std::condition_variable Done;
+    const std::function<void(uint32_t)> *job = nullptr;
+    uint32_t JobSize = 0;
+    std::atomic<uint32_t> next{0};
+    uint32_t pending = 0; // calls of fn not finished yet
+    uint32_t active = 0;  // workers inside Work
+    uint64_t generation = 0;
+    bool stopping = false;
+
+    void Work(const std::function<void(uint32_t)> &fn, uint32_t count, bool IsWorker = false)
+    {
+        uint32_t finished = 0;
+        for (uint32_t i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+        {
+            fn(i);
+            ++finished;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        pending -= finished;
+        if (IsWorker)
+            --active;
+        if (pending == 0 && active == 0)
+            Done.notify_all();
+    }
+
+    void WorkerLoop()
+    {
+        uint64_t seen = 0;
+        for (;;)
+        {
+            const std::function<void(uint32_t)> *fn;
+            uint32_t count;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                WakeUp.wait(lock, [&] { return stopping || (generation != seen && job != nullptr); });
+                if (stopping)
+                    return;
+                seen = generation;
+                fn = job;
+                count = JobSize;
+                ++active;
+            }
+            Work(*fn, count, true);
+        }
+    }
+};
+
+// Splits [0, n) into about as many contiguous blocks as the pool has threads (times a small factor for balance)
+// and calls fn(begin, end) on each block in parallel. Blocks hold at least grain items, so short ranges
+// run on the calling thread alone.
+void ParallelFor(ThreadPool &pool, uint64_t n, const std::function<void(uint64_t, uint64_t)> &fn, uint64_t grain = 1)
+{
+    if (n == 0)
+        return;
+    uint64_t blocks = std::max<uint64_t>(1, std::min<uint64_t>(n / std::max<uint64_t>(grain, 1), uint64_t(pool.Size()) * 4));
+    pool.Run(static_cast<uint32_t>(blocks), [&](uint32_t b) {
+        fn(n * b / blocks, n * (b + 1) / blocks);
+    });
+}
+
+// Replaces values by their exclusive prefix sums and returns the total.
+// Each block sums its part, the block sums are scanned, then each block scans its part from its start value.
+uint64_t ParallelPrefixSum(ThreadPool &pool, uint32_t *values, uint64_t n)
+{
+    if (n == 0)
+        return 0;
+    uint64_t blocks = std::min<uint64_t>(n, uint64_t(pool.Size()) * 4);
+    std::vector<uint64_t> BlockSum(blocks + 1, 0);
+    pool.Run(static_cast<uint32_t>(blocks), [&](uint32_t b) {
+        uint64_t sum = 0;
+        for (uint64_t i = n * b / blocks; i < n * (b + 1) / blocks; ++i)
+        {
+            sum += values[i];
+        }
+        BlockSum[b + 1] = sum;
+    });
+    for (uint64_t b = 0; b < blocks; ++b)
+    {
+        BlockSum[b + 1] += BlockSum[b];
+    }
+    pool.Run(static_cast<uint32_t>(blocks), [&](uint32_t b) {
+        uint64_t sum = BlockSum[b];
+        for (uint64_t i = n * b / blocks; i < n * (b + 1) / blocks; ++i)
+        {
+            uint32_t value = values[i];
+            values[i] = static_cast<uint32_t>(sum);
+            sum += value;
+        }
+    });
+    return BlockSum[blocks];
+}
+
+#endif
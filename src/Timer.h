@@ -10,7 +10,7 @@ struct Timer {
 
     ~Timer() {
         if (!hasBeenStopped) {
-            std::cout << Stop() << " ms" << std::endl;
+            std::cout << Stop() << " ms\n";
         }
     }
 
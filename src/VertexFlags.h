@@ -0,0 +1,87 @@
+#ifndef VERTEX_FLAGS_H
+#define VERTEX_FLAGS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One yes/no property of every vertex (visited, articulation point, on a chain, ...), 64 vertices to a word:
+// n / 8 bytes where a hash set of vertex ids takes tens of bytes per member. Clearing, counting (popcount),
+// listing the set vertices and finding the next clear one all go a word at a time.
+template <typename VertexId>
+class BasicVertexFlags
+{
+  public:
+    BasicVertexFlags() = default;
+    explicit BasicVertexFlags(VertexId n) { Reset(n); }
+
+    // n flags, all clear
+    void Reset(VertexId n)
+    {
+        words.assign((size_t(n) + 63) / 64, 0);
+        size = n;
+    }
+
+    VertexId Size() const { return size; }
+    bool operator[](VertexId v) const { return (words[size_t(v) >> 6] >> (v & 63)) & 1; }
+    void Set(VertexId v) { words[size_t(v) >> 6] |= uint64_t(1) << (v & 63); }
+    void Clear(VertexId v) { words[size_t(v) >> 6] &= ~(uint64_t(1) << (v & 63)); }
+
+    // sets the flag of v; true if it was clear
+    bool TestAndSet(VertexId v)
+    {
+        uint64_t bit = uint64_t(1) << (v & 63);
+        bool WasClear = (words[size_t(v) >> 6] & bit) == 0;
+        words[size_t(v) >> 6] |= bit;
+        return WasClear;
+    }
+
+    // the number of set flags
+    VertexId Count() const
+    {
+        uint64_t count = 0;
+        for (auto word : words)
+        {
+            count += static_cast<uint64_t>(__builtin_popcountll(word));
+        }
+        return static_cast<VertexId>(count);
+    }
+
+    // the first vertex from v on whose flag is clear, or Size() if there is none
+    VertexId NextClear(VertexId v) const
+    {
+        if (v >= size)
+            return size;
+        size_t w = size_t(v) >> 6;
+        uint64_t clear = ~words[w] & (~uint64_t(0) << (v & 63));
+        while (clear == 0 && ++w < words.size())
+        {
+            clear = ~words[w];
+        }
+        if (clear == 0)
+            return size;
+        uint64_t found = w * 64 + static_cast<uint64_t>(__builtin_ctzll(clear));
+        return found < size ? static_cast<VertexId>(found) : size;
+    }
+
+    // calls fn(v) for every vertex v whose flag is set, in increasing order
+    template <typename Fn>
+    void ForEach(Fn fn) const
+    {
+        for (size_t w = 0; w < words.size(); ++w)
+        {
+            for (uint64_t word = words[w]; word != 0; word &= word - 1)
+            {
+                fn(static_cast<VertexId>(w * 64 + static_cast<uint64_t>(__builtin_ctzll(word))));
+            }
+        }
+    }
+
+  private:
+    std::vector<uint64_t> words;
+    VertexId size = 0;
+};
+
+using VertexFlags = BasicVertexFlags<uint32_t>;
+
+#endif
@@ -0,0 +1,150 @@
+#include "bcc.h"
+
+// The engine headers report bad input through Fail (utils.h), which throws in the library instead of exiting.
+#define BCC_LIBRARY
+
+// The engine headers define their functions at namespace scope and out of line (LoadGraph, EndsWith,
+// TarjanHopcroft, ...). Included into bcc::detail, every one of them is named in that namespace, so libbcc.a
+// exports nothing a caller might define too. The system headers they include are included first, here at global
+// scope, where their include guards then keep them.
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cassert>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <ios>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <queue>
+#include <sstream>
+#include <stack>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace bcc::detail
+{
+#include "Loader.h"
+#include "TarjanHopcroft.h"
+#include "TarjanVishkin.h"
+#include "ThreadPool.h"
+#include "utils.h"
+} // namespace bcc::detail
+
+namespace bcc
+{
+
+// the simple undirected CSR graph behind a bcc::Graph; never modified after construction
+struct GraphData
+{
+    detail::Graph graph;
+
+    explicit GraphData(detail::Graph &&graph) : graph(std::move(graph)) {}
+};
+
+const GraphData &Data(const Graph &graph) { return *graph.data; }
+
+Graph::Graph(std::unique_ptr<GraphData> data) : data(std::move(data)) {}
+Graph::Graph(Graph &&other) noexcept = default;
+Graph &Graph::operator=(Graph &&other) noexcept = default;
+Graph::~Graph() = default;
+
+uint32_t Graph::NumVertices() const { return data->graph.n; }
+uint64_t Graph::NumEdges() const { return data->graph.AdjArray.size() / 2; }
+
+Graph Graph::Load(const char *path, unsigned NumThreads)
+{
+    detail::Graph graph = detail::LoadGraph(path, NumThreads);
+    detail::MakeUndirected(graph);
+    return Graph(std::make_unique<GraphData>(std::move(graph)));
+}
+
+GraphBuilder::GraphBuilder(uint32_t n, uint64_t ExpectedEdges) : n(n) { edges.reserve(ExpectedEdges); }
+
+void GraphBuilder::AddEdge(uint32_t u, uint32_t v)
+{
+    if (u >= n || v >= n)
+        throw std::out_of_range("bcc::GraphBuilder::AddEdge: edge (" + std::to_string(u) + ", " + std::to_string(v) +
+                                ") has an end not below n = " + std::to_string(n));
+    if (u != v)
+        edges.push_back({u, v});
+}
+
+Graph GraphBuilder::Build()
+{
+    detail::GraphBuilder builder(n);
+    builder.edges.swap(edges);
+    return Graph(std::make_unique<GraphData>(builder.Build()));
+}
+
+Result Biconnectivity(const Graph &graph, unsigned NumThreads)
+{
+    // the engines keep their DFS state in the graph, so each call works on its own graph borrowing the shared arrays
+    const detail::Graph &shared = Data(graph).graph;
+    detail::Graph work(shared.n);
+    work.AdjOffsets.Borrow(shared.AdjOffsets.data(), shared.AdjOffsets.size());
+    work.AdjArray.Borrow(shared.AdjArray.data(), shared.AdjArray.size());
+    work.m = shared.m;
+    work.IsUndirected = true;
+
+    detail::BiconnectivityResult found;
+    if (NumThreads > 1)
+    {
+        detail::ThreadPool pool(NumThreads);
+        detail::TarjanVishkin(work, found, pool);
+    }
+    else
+    {
+        detail::TarjanHopcroft(work, found);
+    }
+
+    Result result;
+    result.ArticulationPoints = std::move(found.ArticulationPoints);
+    result.Bridges = std::move(found.Bridges);
+    result.BiconnectedComponents.ComponentOffsets = std::move(found.ComponentOffsets);
+    result.BiconnectedComponents.ComponentEdges = std::move(found.ComponentEdges);
+    return result;
+}
+
+std::vector<uint32_t> ArticulationPoints(const Graph &graph, unsigned NumThreads)
+{
+    return Biconnectivity(graph, NumThreads).ArticulationPoints;
+}
+
+std::vector<std::pair<uint32_t, uint32_t>> Bridges(const Graph &graph, unsigned NumThreads)
+{
+    return Biconnectivity(graph, NumThreads).Bridges;
+}
+
+Components BiconnectedComponents(const Graph &graph, unsigned NumThreads)
+{
+    return Biconnectivity(graph, NumThreads).BiconnectedComponents;
+}
+
+} // namespace bcc
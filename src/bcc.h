@@ -0,0 +1,91 @@
+#ifndef BCC_H
+#define BCC_H
+
+// Biconnectivity as a library (libbcc.a, see "make lib"), for callers that want results as arrays
+// instead of parsing the text output of tarjan or schmidt.
+// This header is self-contained; the engines behind it are the ones the binaries use.
+//
+//   bcc::GraphBuilder builder(n);
+//   builder.AddEdge(u, v); ...
+//   bcc::Graph graph = builder.Build();
+//   std::vector<uint32_t> cut = bcc::ArticulationPoints(graph);
+//
+// A Graph is immutable once built, so any number of threads may query the same one at once.
+// Errors are thrown, never printed: the library does not exit the process it is linked into.
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace bcc
+{
+
+struct GraphData;
+
+class Graph
+{
+  public:
+    Graph(Graph &&other) noexcept;
+    Graph &operator=(Graph &&other) noexcept;
+    ~Graph();
+
+    uint32_t NumVertices() const;
+    uint64_t NumEdges() const; // undirected edges, each counted once
+
+    // Loads an .in, .mtx or .bcsr file like the binaries do (a .bcsr file is mapped, not copied).
+    // Throws std::runtime_error, with the message they would print, when the file cannot be used.
+    static Graph Load(const char *path, unsigned NumThreads = 1);
+
+  private:
+    explicit Graph(std::unique_ptr<GraphData> data);
+    std::unique_ptr<GraphData> data;
+
+    friend class GraphBuilder;
+    friend const GraphData &Data(const Graph &graph);
+};
+
+// Collects the edges of an undirected graph on vertices 0 ... n - 1, in any order.
+// Self-loops are ignored and repeated edges kept once.
+class GraphBuilder
+{
+  public:
+    explicit GraphBuilder(uint32_t n, uint64_t ExpectedEdges = 0);
+    void AddEdge(uint32_t u, uint32_t v); // throws std::out_of_range unless u, v < n
+    Graph Build();                        // throws std::runtime_error from 2^31 edges on
+
+  private:
+    uint32_t n;
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+};
+
+// Components are stored CSR style: the edges of component c are
+// ComponentEdges[ComponentOffsets[c]] ... ComponentEdges[ComponentOffsets[c + 1] - 1].
+// Edges are (u, v) with u < v, in increasing order within a component; components are numbered by their
+// smallest edge, so the result does not depend on the engine or the number of threads.
+struct Components
+{
+    std::vector<uint32_t> ComponentOffsets;
+    std::vector<std::pair<uint32_t, uint32_t>> ComponentEdges;
+
+    uint32_t NumComponents() const { return static_cast<uint32_t>(ComponentOffsets.size() - 1); }
+};
+
+struct Result
+{
+    std::vector<uint32_t> ArticulationPoints;              // sorted
+    std::vector<std::pair<uint32_t, uint32_t>> Bridges;    // (u, v) with u < v, sorted
+    Components BiconnectedComponents;
+};
+
+// Each call runs one pass over the graph: Tarjan-Hopcroft on one thread, Tarjan-Vishkin on more.
+// Biconnectivity returns everything that pass finds, the other three one part of it.
+Result Biconnectivity(const Graph &graph, unsigned NumThreads = 1);
+std::vector<uint32_t> ArticulationPoints(const Graph &graph, unsigned NumThreads = 1);
+std::vector<std::pair<uint32_t, uint32_t>> Bridges(const Graph &graph, unsigned NumThreads = 1);
+Components BiconnectedComponents(const Graph &graph, unsigned NumThreads = 1);
+
+} // namespace bcc
+
+#endif
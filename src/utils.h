@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <bitset>
 #include <cassert>
+#include <climits>
 #include <cstring>
 #include <fstream>
 #include <ios>
@@ -13,84 +14,479 @@
 #include <iterator>
 #include <limits>
 #include <map>
+#include <memory>
 #include <queue>
 #include <sstream>
 #include <stack>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "Arena.h"
+#include "Instrument.h"
+#include "VertexFlags.h"
+
 using std::cout, std::cin, std::cerr;
 
-struct Tree
+// Ends the run on an input or limit error. The binaries print message and exit(1); the library (built with
+// BCC_LIBRARY, see bcc.cpp) throws it as a std::runtime_error instead, so that it never ends the caller's process.
+[[noreturn]] void Fail(const std::string &message)
 {
-    uint32_t root;
-    struct PointProperties
+#ifdef BCC_LIBRARY
+    throw std::runtime_error(message);
+#else
+    cout << message << "\n";
+    exit(1);
+#endif
+}
+
+// The graph, its DFS state and the results are templates on the width of a vertex id (VertexId) and of a
+// position in the adjacency array (EdgeId), so that a graph is held in the narrowest ids it fits: 16-bit ids
+// halve the adjacency array and the per-vertex state of a graph with fewer than 65535 vertices, 64-bit offsets
+// or ids carry graphs past 2^32 edges or vertices. The plain names (Graph, DFSState, ...) are the 32-bit
+// instantiations everything but the width-specialised linear engine works with.
+
+// the largest id of its type, which no vertex or edge gets: "no parent", "no child", "not discovered yet"
+template <typename Id>
+constexpr Id NoId = std::numeric_limits<Id>::max();
+
+template <typename VertexId>
+struct BasicTree
+{
+    VertexId root;
+    VertexId NumVertices = 0; // number of vertices in the tree
+    struct DiscoveredBackEdge
     {
-        std::vector<uint32_t> neighbours;
-        uint32_t DiscoveryTime;
-        uint32_t Low;
-        uint32_t parent; // = UINT32_MAX for root
-        PointProperties() { DiscoveryTime = Low = UINT32_MAX; }
-        PointProperties(uint32_t DiscoveryTime, uint32_t parent = UINT32_MAX, uint32_t Low = UINT32_MAX)
+        VertexId vertex1; // the upper end, an ancestor of vertex2
+        VertexId vertex2;
+        VertexId DiscoveryTime1;
+        VertexId DiscoveryTime2;
+        DiscoveredBackEdge(VertexId vertex1, VertexId vertex2, VertexId DiscoveryTime1,VertexId DiscoveryTime2)
         {
-            this->DiscoveryTime = DiscoveryTime;
-            this->Low = Low;
-            this->parent = parent;
+            this->DiscoveryTime1 = DiscoveryTime1;
+            this->DiscoveryTime2 = DiscoveryTime2; // dicovery time of vertex 2
+            this->vertex1 = vertex1;
+            this->vertex2 = vertex2;
         }
     };
-    struct DiscoveredBackEdge
+    ArenaVector<DiscoveredBackEdge> BackEdge; // on the heap, or in the arena of the run that collects back edges
+    BasicTree(VertexId root) { this->root = root; }
+    BasicTree(VertexId root, Arena &arena) : BackEdge(ArenaAllocator<DiscoveredBackEdge>(arena)) { this->root = root; }
+};
+
+using Tree = BasicTree<uint32_t>;
+
+// Per-vertex DFS state, stored as one dense array per field and indexed by vertex id.
+// A single instance covers the whole forest; the tree a vertex belongs to is TreeNum[v].
+template <typename VertexId>
+struct BasicDFSState
+{
+    std::vector<VertexId> DiscoveryTime; // = NoId until the vertex is discovered
+    std::vector<VertexId> Low;
+    std::vector<VertexId> Parent;      // = NoId for roots
+    std::vector<VertexId> TreeNum;     // TreeNum[i] is the tree number that vertex i belongs to
+    std::vector<VertexId> FirstChild;  // = NoId for leaves
+    std::vector<VertexId> NextSibling; // next child of Parent[v], = NoId for the last one
+    BasicVertexFlags<VertexId> IsArticulation; // filled in by the engines as they find articulation points
+
+    void Reset(VertexId n)
+    {
+        DiscoveryTime.assign(n, NoId<VertexId>);
+        Low.assign(n, NoId<VertexId>);
+        Parent.assign(n, NoId<VertexId>);
+        TreeNum.assign(n, NoId<VertexId>);
+        FirstChild.assign(n, NoId<VertexId>);
+        NextSibling.assign(n, NoId<VertexId>);
+        IsArticulation.Reset(n);
+    }
+
+    // links child below parent in the DFS tree
+    void AddChild(VertexId parent, VertexId child)
     {
-        uint32_t vertex1;
-        uint32_t vertex2;
-        uint32_t DiscoveryTime1;
-        uint32_t DiscoveryTime2;
-        bool operator<( DiscoveredBackEdge &a) const
+        Parent[child] = parent;
+        NextSibling[child] = FirstChild[parent];
+        FirstChild[parent] = child;
+    }
+};
+
+using DFSState = BasicDFSState<uint32_t>;
+
+// An array backing the CSR graph. It either owns its elements or borrows them from memory
+// that outlives it, such as a mapped binary graph file. Reads never copy; the mutating calls
+// first turn a borrowed array into an owned copy.
+template <typename T>
+class GraphArray
+{
+  public:
+    GraphArray() = default;
+    GraphArray(const GraphArray &other) { *this = other; }
+    GraphArray(GraphArray &&other) noexcept { *this = std::move(other); }
+
+    GraphArray &operator=(const GraphArray &other)
+    {
+        owned = other.owned;
+        borrowed = other.IsBorrowed();
+        ptr = borrowed ? other.ptr : owned.data();
+        len = other.len;
+        return *this;
+    }
+
+    GraphArray &operator=(GraphArray &&other) noexcept
+    {
+        owned = std::move(other.owned);
+        borrowed = other.borrowed;
+        ptr = borrowed ? other.ptr : owned.data();
+        len = other.len;
+        other.Adopt(std::vector<T>());
+        return *this;
+    }
+
+    const T &operator[](size_t i) const { return ptr[i]; }
+    const T *data() const { return ptr; }
+    const T *begin() const { return ptr; }
+    const T *end() const { return ptr + len; }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+    bool IsBorrowed() const { return borrowed; }
+
+    // points the array at count elements owned by someone else
+    void Borrow(const T *elements, size_t count)
+    {
+        std::vector<T>().swap(owned);
+        borrowed = true;
+        ptr = elements;
+        len = count;
+    }
+
+    // takes over elements as the new contents
+    void Adopt(std::vector<T> &&elements)
+    {
+        owned = std::move(elements);
+        borrowed = false;
+        Refresh();
+    }
+
+    void push_back(const T &value)
+    {
+        MakeOwned();
+        owned.push_back(value);
+        Refresh();
+    }
+
+    void reserve(size_t count)
+    {
+        MakeOwned();
+        owned.reserve(count);
+        Refresh();
+    }
+
+    void clear() { Adopt(std::vector<T>()); }
+
+  private:
+    std::vector<T> owned;
+    const T *ptr = nullptr;
+    size_t len = 0;
+    bool borrowed = false;
+
+    void MakeOwned()
+    {
+        if (borrowed)
+            Adopt(std::vector<T>(ptr, ptr + len));
+    }
+
+    void Refresh()
+    {
+        ptr = owned.data();
+        len = owned.size();
+    }
+};
+
+struct MappedFile;
+
+// a contiguous view over the neighbours of one vertex in the CSR arrays
+template <typename VertexId>
+struct BasicNeighbourRange
+{
+    const VertexId *first;
+    const VertexId *last;
+    const VertexId *begin() const { return first; }
+    const VertexId *end() const { return last; }
+    VertexId size() const { return static_cast<VertexId>(last - first); }
+    VertexId operator[](VertexId i) const { return first[i]; }
+};
+
+using NeighbourRange = BasicNeighbourRange<uint32_t>;
+
+template <typename VertexId, typename EdgeId>
+struct BasicGraph
+{
+    VertexId n;
+    EdgeId m;
+    // the graph itself in compressed sparse row form:
+    // the neighbours of v are AdjArray[AdjOffsets[v]] ... AdjArray[AdjOffsets[v + 1] - 1]
+    GraphArray<EdgeId> AdjOffsets;    // n + 1 entries
+    GraphArray<VertexId> AdjArray;    // m entries
+    GraphArray<VertexId> DegreePermutation; // vertex ids by decreasing degree, only if stored in a binary graph
+    std::shared_ptr<const MappedFile> Mapping; // keeps the file alive when the arrays are borrowed from it
+    std::vector<BasicTree<VertexId>> DFSForest; // a spanning forest, one entry per tree
+    BasicDFSState<VertexId> State;    // discovery times, low values and tree links of every vertex, sized by the DFS
+    bool IsUndirected = false;        // every edge is stored in both directions, without repeats or self-loops
+
+    BasicGraph(VertexId n, EdgeId m = 0)
+    {
+        this->n = n;
+        this->m = m;
+        AdjOffsets.reserve(size_t(n) + 1);
+        AdjOffsets.push_back(0);
+        AdjArray.reserve(m);
+    }
+
+    BasicNeighbourRange<VertexId> Adj(VertexId v) const
+    {
+        return BasicNeighbourRange<VertexId>{AdjArray.data() + AdjOffsets[v], AdjArray.data() + AdjOffsets[size_t(v) + 1]};
+    }
+
+    VertexId Degree(VertexId v) const { return static_cast<VertexId>(AdjOffsets[size_t(v) + 1] - AdjOffsets[v]); }
+
+    // closes the neighbour list of the next vertex; called once per vertex, in order, by the loader
+    void EndVertex() { AdjOffsets.push_back(static_cast<EdgeId>(AdjArray.size())); }
+};
+
+using Graph = BasicGraph<uint32_t, uint32_t>;
+
+// expands the CSR graph back into one vector per vertex, for the passes that edit adjacency lists in place
+std::vector<std::vector<uint32_t>> CopyAdjList(const Graph &graph)
+{
+    std::vector<std::vector<uint32_t>> AdjList(graph.n);
+    for (uint32_t i = 0; i < graph.n; ++i)
+    {
+        AdjList[i].assign(graph.Adj(i).begin(), graph.Adj(i).end());
+    }
+    return AdjList;
+}
+
+// Sorts every neighbour list of a CSR graph and drops repeated entries, compacting the arrays in place.
+template <typename VertexId, typename EdgeId>
+void SortAndDeduplicate(std::vector<EdgeId> &offsets, std::vector<VertexId> &array)
+{
+    size_t n = offsets.size() - 1;
+    EdgeId out = 0;
+    for (size_t v = 0; v < n; ++v)
+    {
+        auto first = array.begin() + static_cast<std::ptrdiff_t>(offsets[v]);
+        auto last = array.begin() + static_cast<std::ptrdiff_t>(offsets[v + 1]);
+        std::sort(first, last);
+        last = std::unique(first, last);
+        offsets[v] = out;
+        out = static_cast<EdgeId>(std::copy(first, last, array.begin() + static_cast<std::ptrdiff_t>(out)) - array.begin());
+    }
+    offsets[n] = out;
+    array.resize(out);
+    array.shrink_to_fit();
+}
+
+// Turns graph into a simple undirected graph: every edge is stored in both directions,
+// self-loops and repeated edges are dropped and each neighbour list ends up sorted.
+template <typename VertexId, typename EdgeId>
+void MakeUndirected(BasicGraph<VertexId, EdgeId> &graph)
+{
+    if (graph.IsUndirected)
+        return;
+
+    // every entry may be stored both ways round, and the offsets must count them all
+    if (uint64_t(graph.AdjArray.size()) > std::numeric_limits<EdgeId>::max() / 2)
+        Fail("Error: too many edges for " + std::to_string(8 * sizeof(EdgeId)) + "-bit offsets");
+
+    ScopedPhase phase("make undirected");
+    std::vector<EdgeId> offsets(size_t(graph.n) + 1, 0);
+    for (VertexId v = 0; v < graph.n; ++v)
+    {
+        for (auto w : graph.Adj(v))
         {
-            if( DiscoveryTime2 != a.DiscoveryTime2){
-                return DiscoveryTime2 < a.DiscoveryTime2;
+            if (w != v)
+            {
+                ++offsets[v + 1];
+                ++offsets[w + 1];
             }
-            else{
-                return DiscoveryTime1 < a.DiscoveryTime1;
+        }
+    }
+    for (VertexId v = 0; v < graph.n; ++v)
+    {
+        offsets[v + 1] += offsets[v];
+    }
+
+    std::vector<VertexId> array(offsets[graph.n]);
+    std::vector<EdgeId> fill(offsets.begin(), offsets.end() - 1);
+    for (VertexId v = 0; v < graph.n; ++v)
+    {
+        for (auto w : graph.Adj(v))
+        {
+            if (w != v)
+            {
+                array[fill[v]++] = w;
+                array[fill[w]++] = v;
             }
         }
+    }
+    SortAndDeduplicate(offsets, array);
+
+    graph.AdjOffsets.Adopt(std::move(offsets));
+    graph.AdjArray.Adopt(std::move(array));
+    graph.Mapping.reset();
+    graph.m = static_cast<EdgeId>(graph.AdjArray.size());
+    graph.IsUndirected = true;
+}
+
+// Collects edges in any order and builds a simple undirected CSR graph out of them:
+// both directions are stored, self-loops are ignored and repeated edges kept once.
+struct GraphBuilder
+{
+    uint32_t n;
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+
+    explicit GraphBuilder(uint32_t n, uint64_t ExpectedEdges = 0)
+    {
+        this->n = n;
+        edges.reserve(ExpectedEdges);
+    }
 
-        DiscoveredBackEdge(uint32_t vertex1, uint32_t vertex2, uint32_t DiscoveryTime1,uint32_t DiscoveryTime2)
+    void AddEdge(uint32_t u, uint32_t v)
+    {
+        if (u != v)
+            edges.push_back({u, v});
+    }
+
+    Graph Build()
+    {
+        if (edges.size() * 2 > UINT32_MAX)
+            Fail("Error: too many edges for 32-bit offsets");
+        std::vector<uint32_t> offsets(n + 1, 0);
+        for (auto &e : edges)
         {
-            this->DiscoveryTime1 = DiscoveryTime1;
-            this->DiscoveryTime2 = DiscoveryTime2; // dicovery time of vertex 2
-            this->vertex1 = vertex1;
-            this->vertex2 = vertex2;
+            ++offsets[e.first + 1];
+            ++offsets[e.second + 1];
         }
-    };
-#ifdef DEBUG
-    std::unordered_map<uint32_t, PointProperties> AdjMap;
-#else
-    std::unordered_map<uint32_t, PointProperties> AdjMap;
-#endif
-    std::unordered_set<uint32_t> ArticulationPoints;
-    std::vector<DiscoveredBackEdge> BackEdge;
-    Tree(uint32_t root) { this->root = root; }
+        for (uint32_t v = 0; v < n; ++v)
+        {
+            offsets[v + 1] += offsets[v];
+        }
+
+        std::vector<uint32_t> array(offsets[n]);
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (auto &e : edges)
+        {
+            array[fill[e.first]++] = e.second;
+            array[fill[e.second]++] = e.first;
+        }
+        std::vector<std::pair<uint32_t, uint32_t>>().swap(edges); // release the edge list before compacting
+        SortAndDeduplicate(offsets, array);
+
+        Graph graph(n);
+        graph.AdjOffsets.Adopt(std::move(offsets));
+        graph.AdjArray.Adopt(std::move(array));
+        graph.m = static_cast<uint32_t>(graph.AdjArray.size());
+        graph.IsUndirected = true;
+        return graph;
+    }
 };
 
-struct Graph
+// Articulation points, bridges and biconnected components of a graph.
+// Components are stored CSR style: the edges of component c are
+// ComponentEdges[ComponentOffsets[c]] ... ComponentEdges[ComponentOffsets[c + 1] - 1]
+// (see ListComponents for their order).
+// There are fewer components than vertices, so component numbers are vertex-sized.
+template <typename VertexId, typename EdgeId>
+struct BasicBiconnectivityResult
 {
-    uint32_t n, m;
-    std::vector<std::vector<uint32_t>> AdjList; // the graph itself
-    std::vector<Tree> DFSForest;                // a spanning forest, stored as a list of adjacency lists
-    std::vector<uint32_t> TreeNum;              // TreeNum[i] is the tree number that vertex i belongs to
+    std::vector<VertexId> ArticulationPoints;                       // sorted
+    std::vector<std::pair<VertexId, VertexId>> Bridges;             // (u, v) with u < v, sorted
+    std::vector<EdgeId> ComponentOffsets{0};                        // NumComponents() + 1 entries
+    std::vector<std::pair<VertexId, VertexId>> ComponentEdges;      // every edge exactly once, as (u, v) with u < v
+    std::vector<VertexId> EdgeComponent;                            // component of the edge at each position of graph.AdjArray
 
-    Graph(uint32_t n, uint32_t m = 0)
+    VertexId NumComponents() const { return static_cast<VertexId>(ComponentOffsets.size() - 1); }
+
+    // empties the result but keeps the capacity of its arrays, for analysing one graph after another
+    void Clear()
     {
-        this->n = n;
-        this->m = m;
-        AdjList.resize(n);
-        TreeNum.resize(n, UINT32_MAX);
+        ArticulationPoints.clear();
+        Bridges.clear();
+        ComponentOffsets.assign(1, 0);
+        ComponentEdges.clear();
+        EdgeComponent.clear();
     }
 };
 
+using BiconnectivityResult = BasicBiconnectivityResult<uint32_t, uint32_t>;
+
+// Fills the component lists of result for an undirected simple graph from ComponentOf(u, v, i), a label below
+// graph.n of the component of the edge (u, v) at position i of graph.AdjArray.
+// The listing is canonical, whatever the labels: edges (u, v) with u < v in increasing order, components
+// numbered by their smallest edge. Also fills result.EdgeComponent. Runs in O(n + m).
+template <typename VertexId, typename EdgeId, typename ComponentLabel>
+void ListComponents(const BasicGraph<VertexId, EdgeId> &graph, ComponentLabel ComponentOf, BasicBiconnectivityResult<VertexId, EdgeId> &result)
+{
+    // number the components in order of their smallest edge and count their edges
+    std::vector<VertexId> CanonicalId(graph.n, NoId<VertexId>);
+    std::vector<EdgeId> &offsets = result.ComponentOffsets;
+    offsets.assign(1, 0);
+    for (VertexId u = 0; u < graph.n; ++u)
+    {
+        for (EdgeId i = graph.AdjOffsets[u]; i < graph.AdjOffsets[u + 1]; ++i)
+        {
+            VertexId v = graph.AdjArray[i];
+            if (v <= u)
+                continue;
+            VertexId &id = CanonicalId[ComponentOf(u, v, i)];
+            if (id == NoId<VertexId>)
+            {
+                id = static_cast<VertexId>(offsets.size() - 1);
+                offsets.push_back(0);
+            }
+            ++offsets[id + 1];
+        }
+    }
+    for (size_t c = 1; c < offsets.size(); ++c)
+    {
+        offsets[c] += offsets[c - 1];
+    }
+
+    result.ComponentEdges.resize(offsets.back());
+    result.EdgeComponent.resize(graph.AdjArray.size());
+    std::vector<EdgeId> fill(offsets.begin(), offsets.end() - 1);
+    for (VertexId u = 0; u < graph.n; ++u)
+    {
+        for (EdgeId i = graph.AdjOffsets[u]; i < graph.AdjOffsets[u + 1]; ++i)
+        {
+            VertexId v = graph.AdjArray[i];
+            VertexId id = CanonicalId[ComponentOf(u, v, i)];
+            result.EdgeComponent[i] = id;
+            if (v > u)
+                result.ComponentEdges[fill[id]++] = {u, v};
+        }
+    }
+}
+
+// Fills the component lists of result for an undirected simple graph covered by a spanning forest.
+// Every component is identified through the tree edges: label[v] is the component of the tree edge
+// (parent[v], v), and a non-tree edge belongs to the component of the parent edge of its endpoint with the
+// larger order (discovery time or preorder number), as in Tarjan-Vishkin. Runs in O(n + m).
+template <typename VertexId, typename EdgeId>
+void BuildComponentLists(const BasicGraph<VertexId, EdgeId> &graph, const std::vector<VertexId> &parent, const std::vector<VertexId> &order,
+                         const std::vector<VertexId> &label, BasicBiconnectivityResult<VertexId, EdgeId> &result)
+{
+    ListComponents(graph, [&](VertexId u, VertexId v, EdgeId) {
+        if (parent[v] == u)
+            return label[v];
+        if (parent[u] == v)
+            return label[u];
+        return order[u] > order[v] ? label[u] : label[v];
+    }, result);
+}
+
 bool IsWhitespace(const std::string &str)
 {
     if (str.find_first_not_of(" \t\n\v\f\r") == std::string::npos)
@@ -98,15 +494,39 @@ bool IsWhitespace(const std::string &str)
     return false;
 }
 
-void SkipNLines(std::ifstream &InputFile, uint64_t n, std::ios::seekdir whence = std::ios::cur,
-                std::streamoff offset = 0)
+bool EndsWith(const char *str, const char *suffix)
 {
-    InputFile.seekg(offset, whence);
-    std::string line;
-    for (uint64_t i = 0; i < n; ++i)
-    {
-        getline(InputFile, line);
-    }
+    size_t len = strlen(str), SuffixLen = strlen(suffix);
+    return len >= SuffixLen && !strcmp(str + len - SuffixLen, suffix);
+}
+
+// If arg is "<name>=<value>", points value at <value> and returns true
+bool MatchOption(const char *arg, const char *name, const char *&value)
+{
+    size_t len = strlen(name);
+    if (strncmp(arg, name, len) != 0 || arg[len] != '=')
+        return false;
+    value = arg + len + 1;
+    return true;
+}
+
+// value as a positive decimal number, 0 for anything else
+uint64_t ParsePositive(const char *value)
+{
+    char *end;
+    if (*value < '0' || *value > '9')
+        return 0;
+    unsigned long long number = strtoull(value, &end, 10);
+    if (*end != '\0' || number == ULLONG_MAX)
+        return 0;
+    return number;
+}
+
+// number of threads for "--threads=<count>", 0 (all cores) for anything that is not a positive number
+unsigned ParseThreadCount(const char *value)
+{
+    uint64_t count = ParsePositive(value);
+    return count <= 4096 ? static_cast<unsigned>(count) : 0;
 }
 
 void OpenInputFile(std::ifstream &InputFile, char *path)
@@ -162,10 +582,11 @@ void PrintGraph(const Graph &graph, bool MatchInputFormat = false)
     {
         if (!MatchInputFormat)
             cout << i << " | ";
-        for (uint32_t j = 0; j < graph.AdjList[i].size(); ++j)
+        auto neighbours = graph.Adj(i);
+        for (uint32_t j = 0; j < neighbours.size(); ++j)
         {
-            cout << graph.AdjList[i][j];
-            if (j < graph.AdjList[i].size() - 1)
+            cout << neighbours[j];
+            if (j < neighbours.size() - 1)
             {
                 cout << " ";
             }
@@ -176,6 +597,25 @@ void PrintGraph(const Graph &graph, bool MatchInputFormat = false)
 #endif
 }
 
+// lists the vertices of tree in breadth-first order, starting from its root
+void LevelOrderTraversal(const Tree &tree, const DFSState &state, std::vector<uint32_t> &LevelOrder)
+{
+    // Performs BFS; LevelOrder doubles as the queue
+    LevelOrder.clear();
+    LevelOrder.reserve(tree.NumVertices);
+    LevelOrder.push_back(tree.root);
+
+    for (uint32_t head = 0; head < LevelOrder.size(); ++head)
+    {
+        for (uint32_t c = state.FirstChild[LevelOrder[head]]; c != UINT32_MAX; c = state.NextSibling[c])
+        {
+            LevelOrder.push_back(c);
+        }
+    }
+
+    assert(LevelOrder.size() == tree.NumVertices);
+}
+
 void PrintForest(const std::vector<Tree> &Forest, const Graph &graph)
 {
 #ifdef DEBUG
@@ -183,21 +623,24 @@ void PrintForest(const std::vector<Tree> &Forest, const Graph &graph)
     {
         cout << "TREE " << i << "\n";
         cout << "Root: " << Forest[i].root << "\n";
-        for (auto &it : Forest[i].AdjMap)
+        std::vector<uint32_t> LevelOrder;
+        LevelOrderTraversal(Forest[i], graph.State, LevelOrder);
+        for (auto &v : LevelOrder)
         {
-            cout << it.first << " | d=" << it.second.DiscoveryTime << " | TreeNum=" << graph.TreeNum.at(it.first)
-                 << " | low=" << it.second.Low << " | ";
-            for (auto &v : it.second.neighbours)
+            cout << v << " | d=" << graph.State.DiscoveryTime[v] << " | TreeNum=" << graph.State.TreeNum[v]
+                 << " | low=" << graph.State.Low[v] << " | ";
+            for (uint32_t c = graph.State.FirstChild[v]; c != UINT32_MAX; c = graph.State.NextSibling[c])
             {
-                cout << v << " ";
+                cout << c << " ";
             }
             cout << "\n";
         }
 
         cout << "Articulation Points: ";
-        for (auto &it : Forest[i].ArticulationPoints)
+        for (auto &v : LevelOrder)
         {
-            cout << it << " ";
+            if (graph.State.IsArticulation[v])
+                cout << v << " ";
         }
         cout << "\n\n";
     }